@@ -3,6 +3,8 @@
 #include <numeric>
 #include <vector>
 
+namespace {
+
 struct Elf : Paragraph_Reader<Elf> {
 	using Reader_Type = Paragraph_Reader<Elf>;
 	using Reader_Type::Reader_Type;
@@ -11,16 +13,11 @@ struct Elf : Paragraph_Reader<Elf> {
 		return total_;
 	}
 
-	void read_line(const std::string &line) final {
-		item_calories_.push_back(std::stoi(line));
-	}
-
-	void read_end() final {
-		total_ = std::reduce(item_calories_.begin(), item_calories_.end());
+	void read_line(std::size_t, std::string_view line) {
+		total_ += parse_number(line);
 	}
 private:
-	std::vector<int> item_calories_;
-	int total_;
+	int total_{0};
 };
 
 struct Compare_Elves {
@@ -35,19 +32,20 @@ int sum_top_three(std::vector<Elf> elves) {
 	return std::accumulate(top3_iter, elves.end(), 0, [](auto sum, const auto &elf) { return sum + elf.total(); });
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Elf> elves;
-	while (has_input(std::cin))
-		elves.push_back(Elf::create_from_stream(std::cin));
-
-	switch (part) {
-	case 1:
-		std::cout << std::max_element(elves.begin(), elves.end(), Compare_Elves{})->total() << std::endl;
-		break;
-	case 2:
-		std::cout << sum_top_three(std::move(elves)) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Elf> parse(Input_Source &input) {
+		return read_records<Elf>(input);
+	}
+
+	static int part1(const std::vector<Elf> &elves) {
+		return std::max_element(elves.begin(), elves.end(), Compare_Elves{})->total();
 	}
-	return 0;
+
+	static int part2(std::vector<Elf> elves) {
+		return sum_top_three(std::move(elves));
+	}
+};
+
 }
+
+AOC_SOLUTION(1, Solution)
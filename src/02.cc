@@ -2,6 +2,8 @@
 #include <numeric>
 #include <vector>
 
+namespace {
+
 struct Round : Token_Reader<Round> {
 	using Reader_Type = Token_Reader<Round>;
 	using Reader_Type::Reader_Type;
@@ -9,8 +11,8 @@ struct Round : Token_Reader<Round> {
 	enum class Selection { ROCK = 0, PAPER = 1, SCISSORS = 2 };
 	enum class Code { X = 0, Y = 1, Z = 2 };
 
-	void read_token(const std::string &token) final {
-		switch (token_num()) {
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
 		case 0:
 			switch (token[0]) {
 			case 'A': opponent_ = Selection::ROCK; break;
@@ -71,18 +73,20 @@ private:
 	return std::accumulate(rounds.begin(), rounds.end(), 0, [](auto sum, const auto &round) { return sum + round.score2(); });
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Round> rounds;
-	while (has_input(std::cin))
-		rounds.push_back(Round::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << total_score1(rounds) << std::endl;
-		break;
-	case 2:
-		std::cout << total_score2(rounds) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Round> parse(Input_Source &input) {
+		return read_records<Round>(input);
+	}
+
+	static int part1(const std::vector<Round> &rounds) {
+		return total_score1(rounds);
+	}
+
+	static int part2(const std::vector<Round> &rounds) {
+		return total_score2(rounds);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(2, Solution)
@@ -4,6 +4,8 @@
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 struct Rucksack : Line_Reader<Rucksack> {
 	using Reader_Type = Line_Reader<Rucksack>;
 	using Reader_Type::Reader_Type;
@@ -12,11 +14,11 @@ struct Rucksack : Line_Reader<Rucksack> {
 		return 'a' <= item && item <= 'z' ? item - 'a' + 1 : item - 'A' + 27;
 	}
 
-	void read_line(const std::string &line) final {
+	void read_line(std::string_view line) {
 		items_ = line;
 	}
 
-	[[nodiscard]] const std::string &items() const noexcept {
+	[[nodiscard]] std::string_view items() const noexcept {
 		return items_;
 	}
 
@@ -31,7 +33,7 @@ struct Rucksack : Line_Reader<Rucksack> {
 				[&compartment1](auto item) { return compartment1.find(item) != compartment1.end(); });
 	}
 private:	
-	std::string items_;
+	std::string_view items_;
 };
 
 [[nodiscard]] static int mismatched_priority(const Rucksack &rucksack1, const Rucksack &rucksack2, const Rucksack &rucksack3) {
@@ -45,24 +47,24 @@ private:
 			[&rucksack12_set](auto item) { return rucksack12_set.find(item) != rucksack12_set.end(); }));
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Rucksack> rucksacks;
-	while (has_input(std::cin))
-		rucksacks.push_back(Rucksack::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << std::accumulate(rucksacks.begin(), rucksacks.end(), 0,
-				[](auto sum, const auto &rucksack) { return sum + rucksack.mismatched_priority(); }) << std::endl;
-		break;
-	case 2:
-		{
-			int sum{0};
-			for (auto rucksack_it = rucksacks.begin(); rucksack_it != rucksacks.end(); rucksack_it += 3)
-				sum += mismatched_priority(*rucksack_it, *std::next(rucksack_it, 1), *std::next(rucksack_it, 2));
-			std::cout << sum << std::endl;
-			break;
-		}
+struct Solution {
+	static std::vector<Rucksack> parse(Input_Source &input) {
+		return read_records<Rucksack>(input);
+	}
+
+	static int part1(const std::vector<Rucksack> &rucksacks) {
+		return std::accumulate(rucksacks.begin(), rucksacks.end(), 0,
+				[](auto sum, const auto &rucksack) { return sum + rucksack.mismatched_priority(); });
+	}
+
+	static int part2(const std::vector<Rucksack> &rucksacks) {
+		int sum{0};
+		for (auto rucksack_it = rucksacks.begin(); rucksack_it != rucksacks.end(); rucksack_it += 3)
+			sum += mismatched_priority(*rucksack_it, *std::next(rucksack_it, 1), *std::next(rucksack_it, 2));
+		return sum;
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(3, Solution)
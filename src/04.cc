@@ -2,14 +2,16 @@
 #include <numeric>
 #include <vector>
 
+namespace {
+
 struct Assignment_Pair : Token_Reader<Assignment_Pair, ','> {
 	using Reader_Type = Token_Reader<Assignment_Pair, ','>;
 	using Reader_Type::Reader_Type;
 
-	void read_token(const std::string &token) final {
+	void read_token(std::size_t token_num, std::string_view token) {
 		const auto delim_pos = token.find('-');
-		(token_num() == 0 ? range1_ : range2_) = std::make_pair(std::stoi(token.substr(0, delim_pos)),
-																std::stoi(token.substr(delim_pos + 1)));
+		(token_num == 0 ? range1_ : range2_) = Range{parse_number(token.substr(0, delim_pos)),
+													 parse_number(token.substr(delim_pos + 1))};
 	}
 
 	[[nodiscard]] bool fully_overlapping() const noexcept {
@@ -23,21 +25,27 @@ struct Assignment_Pair : Token_Reader<Assignment_Pair, ','> {
 	}
 
 private:
-	std::pair<int, int> range1_, range2_;
+	struct Range {
+		int first, second;
+	};
+
+	Range range1_, range2_;
 };
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Assignment_Pair> assignment_pairs;
-	while (has_input(std::cin))
-		assignment_pairs.push_back(Assignment_Pair::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << std::accumulate(assignment_pairs.begin(), assignment_pairs.end(), 0, [](auto sum, const auto &pair) { return sum + pair.fully_overlapping(); }) << std::endl;
-		break;
-	case 2:
-		std::cout << std::accumulate(assignment_pairs.begin(), assignment_pairs.end(), 0, [](auto sum, const auto &pair) { return sum + pair.partially_overlapping(); }) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Assignment_Pair> parse(Input_Source &input) {
+		return read_records<Assignment_Pair>(input);
 	}
-	return 0;
+
+	static int part1(const std::vector<Assignment_Pair> &assignment_pairs) {
+		return std::accumulate(assignment_pairs.begin(), assignment_pairs.end(), 0, [](auto sum, const auto &pair) { return sum + pair.fully_overlapping(); });
+	}
+
+	static int part2(const std::vector<Assignment_Pair> &assignment_pairs) {
+		return std::accumulate(assignment_pairs.begin(), assignment_pairs.end(), 0, [](auto sum, const auto &pair) { return sum + pair.partially_overlapping(); });
+	}
+};
+
 }
+
+AOC_SOLUTION(4, Solution)
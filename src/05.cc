@@ -1,69 +1,84 @@
 #include "common.h"
 #include <array>
 #include <numeric>
+#include <string>
 #include <vector>
 
+namespace {
+
 using Crates = std::array<std::vector<char>, 9>;
 
 struct Instruction : Token_Reader<Instruction> {
 	using Reader_Type = Token_Reader<Instruction>;
 	using Reader_Type::Reader_Type;
 
-	void read_token(const std::string &token) final {
-		if (last_token_ == "move") {
-			count_ = std::stoi(token);
-		} else if (last_token_ == "from") {
-			from_ = std::stoi(token) - 1;
-		} else if (last_token_ == "to") {
-			to_ = std::stoi(token) - 1;
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
+		case 1:
+			count_ = parse_number(token);
+			break;
+		case 3:
+			from_ = parse_number<std::size_t>(token) - 1;
+			break;
+		case 5:
+			to_ = parse_number<std::size_t>(token) - 1;
+			break;
 		}
-		last_token_ = token;
 	}
 
-	void apply_single_move(Crates &crates) {
+	void apply_single_move(Crates &crates) const {
 		std::move(crates[from_].rbegin(), crates[from_].rbegin() + count_, std::back_inserter(crates[to_]));
 		crates[from_].resize(crates[from_].size() - count_);
 	}
 
-	void apply_multi_move(Crates &crates) {
+	void apply_multi_move(Crates &crates) const {
 		std::move(crates[from_].end() - count_, crates[from_].end(), std::back_inserter(crates[to_]));
 		crates[from_].resize(crates[from_].size() - count_);
 	}
 private:
-	std::string last_token_{};
 	int count_;
 	std::size_t from_, to_;
 };
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	Crates crates{
-		std::vector<char>{'R', 'G', 'J', 'B', 'T', 'V', 'Z'},
-		std::vector<char>{'J', 'R', 'V', 'L'},
-		std::vector<char>{'S', 'Q', 'F'},
-		std::vector<char>{'Z', 'H', 'N', 'L', 'F', 'V', 'Q', 'G'},
-		std::vector<char>{'R', 'Q', 'T', 'J', 'C', 'S', 'M', 'W'},
-		std::vector<char>{'S', 'W', 'T', 'C', 'H', 'F'},
-		std::vector<char>{'D', 'Z', 'C', 'V', 'F', 'N', 'J'},
-		std::vector<char>{'L', 'G', 'Z', 'D', 'W', 'R', 'F', 'Q'},
-		std::vector<char>{'J', 'B', 'W', 'V', 'P'}
-	};
+static const Crates INITIAL_CRATES{
+	std::vector<char>{'R', 'G', 'J', 'B', 'T', 'V', 'Z'},
+	std::vector<char>{'J', 'R', 'V', 'L'},
+	std::vector<char>{'S', 'Q', 'F'},
+	std::vector<char>{'Z', 'H', 'N', 'L', 'F', 'V', 'Q', 'G'},
+	std::vector<char>{'R', 'Q', 'T', 'J', 'C', 'S', 'M', 'W'},
+	std::vector<char>{'S', 'W', 'T', 'C', 'H', 'F'},
+	std::vector<char>{'D', 'Z', 'C', 'V', 'F', 'N', 'J'},
+	std::vector<char>{'L', 'G', 'Z', 'D', 'W', 'R', 'F', 'Q'},
+	std::vector<char>{'J', 'B', 'W', 'V', 'P'}
+};
+
+static std::string top_crates(const Crates &crates) {
+	std::string tops;
+	for (const auto &stack : crates)
+		tops.push_back(stack.back());
+	return tops;
+}
+
+struct Solution {
+	static std::vector<Instruction> parse(Input_Source &input) {
+		return read_records<Instruction>(input);
+	}
 
-	std::vector<Instruction> instructions;
-	while (has_input(std::cin))
-		instructions.push_back(Instruction::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		for (auto &instruction : instructions)
+	static std::string part1(const std::vector<Instruction> &instructions) {
+		auto crates = INITIAL_CRATES;
+		for (const auto &instruction : instructions)
 			instruction.apply_single_move(crates);
-		break;
-	case 2:
-		for (auto &instruction : instructions)
+		return top_crates(crates);
+	}
+
+	static std::string part2(const std::vector<Instruction> &instructions) {
+		auto crates = INITIAL_CRATES;
+		for (const auto &instruction : instructions)
 			instruction.apply_multi_move(crates);
-		break;
+		return top_crates(crates);
 	}
-	for (const auto &stack : crates)
-		std::cout << stack.back();
-	std::cout << std::endl;
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(5, Solution)
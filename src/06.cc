@@ -1,7 +1,9 @@
 #include "common.h"
 #include <unordered_map>
 
-static std::size_t find_marker(const std::string &buffer, std::size_t marker_length) {
+namespace {
+
+static std::size_t find_marker(std::string_view buffer, std::size_t marker_length) {
 	std::unordered_map<char, std::size_t> prev_map;
 	for (std::size_t pos = 0; pos < marker_length; ++pos)
 		++prev_map[buffer[pos]];
@@ -19,16 +21,20 @@ static std::size_t find_marker(const std::string &buffer, std::size_t marker_len
 	throw std::logic_error{"No marker found"};
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto line = read_line(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << find_marker(line, 4) << std::endl;
-		break;
-	case 2:
-		std::cout << find_marker(line, 14) << std::endl;
-		break;
+struct Solution {
+	static std::string_view parse(Input_Source &input) {
+		return read_line(input);
+	}
+
+	static std::size_t part1(std::string_view line) {
+		return find_marker(line, 4);
 	}
-	return 0;
+
+	static std::size_t part2(std::string_view line) {
+		return find_marker(line, 14);
+	}
+};
+
 }
+
+AOC_SOLUTION(6, Solution)
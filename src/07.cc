@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <vector>
 
+namespace {
+
 enum class Type { COMMAND, FILE, DIR };
 enum class Command_Type { CD, LS };
 
@@ -12,8 +14,8 @@ static constexpr uint FREE_SPACE_TARGET{30000000};
 
 struct Terminal_Line : Token_Reader<Terminal_Line> {	
 
-	void read_token(const std::string &token) final {
-		switch (token_num()) {
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
 		case 0:
 			if (token == "$") {
 				type_ = Type::COMMAND;
@@ -22,7 +24,7 @@ struct Terminal_Line : Token_Reader<Terminal_Line> {
 				file_size_ = 0;
 			} else {
 				type_ = Type::FILE;
-				file_size_ = std::stoi(token);
+				file_size_ = parse_number(token);
 			}
 			break;
 		case 1:
@@ -51,7 +53,7 @@ struct Terminal_Line : Token_Reader<Terminal_Line> {
 		return command_type_;
 	}
 
-	[[nodiscard]] const std::string &file_name() const noexcept {
+	[[nodiscard]] std::string_view file_name() const noexcept {
 		return file_name_;
 	}
 
@@ -62,7 +64,7 @@ struct Terminal_Line : Token_Reader<Terminal_Line> {
 private:
 	Type type_;
 	Command_Type command_type_;
-	std::string file_name_;
+	std::string_view file_name_;
 	uint file_size_;
 };
 
@@ -70,8 +72,8 @@ struct Node {
 
 	Node() : Node{"/", *this, true} { }
 
-	Node(std::string name, Node &parent, bool is_dir, uint size = 0)
-			: name_{std::move(name)},
+	Node(std::string_view name, Node &parent, bool is_dir, uint size = 0)
+			: name_{name},
 			  parent_{&parent},
 			  is_dir_{is_dir},
 			  size_{size} {
@@ -89,11 +91,11 @@ struct Node {
 		return *parent_;
 	}
 
-	Node &emplace_child_dir(const std::string &name) {
+	Node &emplace_child_dir(std::string_view name) {
 		return emplace_child(name, true, 0);
 	}
 
-	Node &emplace_child_file(const std::string &name, uint size) {
+	Node &emplace_child_file(std::string_view name, uint size) {
 		return emplace_child(name, false, size);
 	}	
 
@@ -113,13 +115,13 @@ struct Node {
 	}
 
 private:
-	std::string name_;
+	std::string_view name_;
 	Node *parent_;
 	bool is_dir_;
 	mutable uint size_;
-	std::unordered_map<std::string, std::unique_ptr<Node>> children_;
+	std::unordered_map<std::string_view, std::unique_ptr<Node>> children_;
 
-	Node &emplace_child(const std::string &name, bool is_dir, uint size) {
+	Node &emplace_child(std::string_view name, bool is_dir, uint size) {
 		auto it = children_.find(name);
 		if (it == children_.end())
 			it = children_.emplace(name, std::make_unique<Node>(name, *this, is_dir, size)).first;
@@ -157,38 +159,51 @@ std::unique_ptr<Node> create_tree(const std::vector<Terminal_Line> &terminal_lin
 	return root;
 }
 
-static uint sum_large_dirs(const Node &root) {
-	uint sum{0};
-	root.visit([&sum](const Node &node) {
-		if (node.is_dir() && node.size() <= 100000)
-			sum += node.size();
+/*
+ * Sizes of every directory, the root's first. Computed once while parsing and shared by both parts.
+ */
+static std::vector<uint> directory_sizes(const Node &root) {
+	std::vector<uint> sizes;
+	root.visit([&sizes](const Node &node) {
+		if (node.is_dir())
+			sizes.push_back(node.size());
 	});
+	return sizes;
+}
+
+static uint sum_large_dirs(const std::vector<uint> &dir_sizes) {
+	uint sum{0};
+	for (auto size : dir_sizes) {
+		if (size <= 100000)
+			sum += size;
+	}
 	return sum;
 }
 
-static uint deletion_dir_size(const Node &root) {
-	const auto free_space = TOTAL_SPACE - root.size();
+static uint deletion_dir_size(const std::vector<uint> &dir_sizes) {
+	const auto free_space = TOTAL_SPACE - dir_sizes.front();
 	auto smallest_size{std::numeric_limits<uint>::max()};
-	root.visit([free_space, &smallest_size](const Node &node) {
-		if (free_space + node.size() >= FREE_SPACE_TARGET && node.size() < smallest_size)
-			smallest_size = node.size();
-	});
+	for (auto size : dir_sizes) {
+		if (free_space + size >= FREE_SPACE_TARGET && size < smallest_size)
+			smallest_size = size;
+	}
 	return smallest_size;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Terminal_Line> terminal_lines;
-	while (has_input(std::cin))
-		terminal_lines.push_back(Terminal_Line::create_from_stream(std::cin));
-	const auto root_ptr = create_tree(terminal_lines);
-	switch (part) {
-	case 1:
-		std::cout << sum_large_dirs(*root_ptr) << std::endl;
-		break;
-	case 2:
-		std::cout << deletion_dir_size(*root_ptr) << std::endl;
-		break;
-	}
-	return 0;
+struct Solution {
+	static std::vector<uint> parse(Input_Source &input) {
+		return directory_sizes(*create_tree(read_records<Terminal_Line>(input)));
+	}
+
+	static uint part1(const std::vector<uint> &dir_sizes) {
+		return sum_large_dirs(dir_sizes);
+	}
+
+	static uint part2(const std::vector<uint> &dir_sizes) {
+		return deletion_dir_size(dir_sizes);
+	}
+};
+
 }
+
+AOC_SOLUTION(7, Solution)
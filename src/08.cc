@@ -1,54 +1,73 @@
 #include "common.h"
-#include <numeric>
+#include <algorithm>
 
-static uint count_visible(const std::vector<std::vector<int>> &grid) {
-	const auto num_cols = grid[0].size();
-	std::vector<std::vector<std::uint8_t>> is_visible(grid.size(), std::vector<std::uint8_t>(num_cols, false));
-	auto update_largest = [&grid, &is_visible](auto &largest, std::size_t row, std::size_t col) {
-		if (grid[row][col] > largest) {
-			is_visible[row][col] = true;
-			largest = grid[row][col];
-		}
-	};
+namespace {
 
-	for (std::size_t row = 0; row < grid.size(); ++row) {
-		is_visible[row][0] = is_visible[row][num_cols - 1] = true;
-		auto largest = grid[row][0];
-		for (std::size_t col = 1; col < num_cols; ++col)
-			update_largest(largest, row, col);
+static uint count_visible(const Grid<int> &grid) {
+	const auto num_rows = grid.height(), num_cols = grid.width();
+	Grid<std::uint8_t> is_visible{num_rows, num_cols, false};
 
-		largest = grid[row][num_cols - 1];
-		for (ssize_t col = num_cols - 1; col >= 0; --col)
-			update_largest(largest, row, col);
-	}
-	for (std::size_t col = 0; col < num_cols; ++col) {
-		is_visible[0][col] = is_visible[grid.size() - 1][col] = true;
-		auto largest = grid[0][col];
-		for (std::size_t row = 1; row < grid.size(); ++row)
-			update_largest(largest, row, col);
+	for (std::size_t row = 0; row < num_rows; ++row) {
+		const auto heights = grid.row(row);
+		const auto visible = is_visible.row(row);
+		visible.front() = visible.back() = true;
+		auto largest = heights.front();
+		for (std::size_t col = 1; col < num_cols; ++col) {
+			if (heights[col] > largest) {
+				visible[col] = true;
+				largest = heights[col];
+			}
+		}
 
-		largest = grid[grid.size() - 1][col];
-		for (ssize_t row = grid.size() - 1; row >= 0; --row)
-			update_largest(largest, row, col);
+		largest = heights.back();
+		for (ssize_t col = num_cols - 1; col >= 0; --col) {
+			if (heights[col] > largest) {
+				visible[col] = true;
+				largest = heights[col];
+			}
+		}
 	}
 
-	return std::accumulate(is_visible.begin(), is_visible.end(), 0u,
-			[](auto sum, const auto &row) { return sum + std::count(row.begin(), row.end(), true); });
+	// Columns are scanned a whole row at a time, tracking the tallest tree seen so far in every column,
+	// so both vertical passes walk memory contiguously.
+	const auto update_largest = [&grid, &is_visible](std::vector<int> &largest, std::size_t row) {
+		const auto heights = grid.row(row);
+		const auto visible = is_visible.row(row);
+		for (std::size_t col = 0; col < heights.size(); ++col) {
+			if (heights[col] > largest[col]) {
+				visible[col] = true;
+				largest[col] = heights[col];
+			}
+		}
+	};
+
+	std::ranges::fill(is_visible.row(0), true);
+	std::vector<int> largest{grid.row(0).begin(), grid.row(0).end()};
+	for (std::size_t row = 1; row < num_rows; ++row)
+		update_largest(largest, row);
+
+	std::ranges::fill(is_visible.row(num_rows - 1), true);
+	largest.assign(grid.row(num_rows - 1).begin(), grid.row(num_rows - 1).end());
+	for (ssize_t row = num_rows - 1; row >= 0; --row)
+		update_largest(largest, row);
+
+	return std::ranges::count(is_visible.cells(), true);
 }
 
-static uint highest_scenic_score(const std::vector<std::vector<int>> &grid) {
-	const auto num_rows = grid.size(), num_cols = grid[0].size();
+static uint highest_scenic_score(const Grid<int> &grid) {
+	const auto num_rows = grid.height(), num_cols = grid.width();
 	uint highest_score{0};
 	for (std::size_t row = 1; row < num_rows - 1; ++row) {
 		for (std::size_t col = 1; col < num_cols - 1; ++col) {
+			const auto height = grid(row, col);
 			uint up_view{1}, down_view{1}, left_view{1}, right_view{1};
-			while (up_view < row && grid[row - up_view][col] < grid[row][col])
+			while (up_view < row && grid(row - up_view, col) < height)
 				++up_view;
-			while (row + down_view < num_rows - 1 && grid[row + down_view][col] < grid[row][col])
+			while (row + down_view < num_rows - 1 && grid(row + down_view, col) < height)
 				++down_view;
-			while (left_view < col && grid[row][col- left_view] < grid[row][col])
+			while (left_view < col && grid(row, col - left_view) < height)
 				++left_view;
-			while (col + right_view < num_cols - 1 && grid[row][col + right_view] < grid[row][col])
+			while (col + right_view < num_cols - 1 && grid(row, col + right_view) < height)
 				++right_view;
 			highest_score = std::max(highest_score, up_view * down_view * left_view * right_view);
 		}
@@ -56,16 +75,20 @@ static uint highest_scenic_score(const std::vector<std::vector<int>> &grid) {
 	return highest_score;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto grid = read_integer_grid(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << count_visible(grid) << std::endl;
-		break;
-	case 2:
-		std::cout << highest_scenic_score(grid) << std::endl;
-		break;
+struct Solution {
+	static Grid<int> parse(Input_Source &input) {
+		return read_integer_grid(input);
+	}
+
+	static uint part1(const Grid<int> &grid) {
+		return count_visible(grid);
 	}
-	return 0;
+
+	static uint part2(const Grid<int> &grid) {
+		return highest_scenic_score(grid);
+	}
+};
+
 }
+
+AOC_SOLUTION(8, Solution)
@@ -1,13 +1,14 @@
 #include "common.h"
-#include <unordered_set>
+
+namespace {
 
 enum class Direction {
 	UP, DOWN, LEFT, RIGHT
 };
 
 struct Move : Token_Reader<Move> {
-	void read_token(const std::string &token) final {
-		switch (token_num()) {
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
 		case 0:
 			if (token == "U")
 				direction_ = Direction::UP;
@@ -19,7 +20,7 @@ struct Move : Token_Reader<Move> {
 				direction_ = Direction::RIGHT;
 			break;
 		case 1:
-			count_ = std::stoi(token);
+			count_ = parse_number(token);
 			break;
 		}
 	}
@@ -46,7 +47,7 @@ static void follow(int &coord, int target) {
 
 static std::size_t model_movement(const std::vector<Direction> &move_directions, std::size_t num_knots) {
 	std::vector<Position> knots(num_knots, Position{0, 0});
-	std::unordered_set<Position> tail_positions{knots.back()};
+	Position_Set tail_positions{knots.back()};
 	for (auto direction : move_directions) {
 		switch (direction) {
 			case Direction::UP: --knots.front().y; break;
@@ -74,22 +75,26 @@ static std::size_t model_movement(const std::vector<Direction> &move_directions,
 	return tail_positions.size();
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Direction> move_directions;
-	while (has_input(std::cin)) {
-		const auto move = Move::create_from_stream(std::cin);
-		for (std::size_t i = 0; i < move.count(); ++i)
-			move_directions.push_back(move.direction());
+struct Solution {
+	static std::vector<Direction> parse(Input_Source &input) {
+		std::vector<Direction> move_directions;
+		while (has_input(input)) {
+			const auto move = Move::create_from_input(input);
+			for (std::size_t i = 0; i < move.count(); ++i)
+				move_directions.push_back(move.direction());
+		}
+		return move_directions;
+	}
+
+	static std::size_t part1(const std::vector<Direction> &move_directions) {
+		return model_movement(move_directions, 2);
 	}
 
-	switch (part) {
-	case 1:
-		std::cout << model_movement(move_directions, 2) << std::endl;
-		break;
-	case 2:
-		std::cout << model_movement(move_directions, 10) << std::endl;
-		break;
+	static std::size_t part2(const std::vector<Direction> &move_directions) {
+		return model_movement(move_directions, 10);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(9, Solution)
@@ -1,8 +1,11 @@
 #include "common.h"
 #include <array>
 #include <deque>
+#include <string>
 #include <vector>
 
+namespace {
+
 static constexpr std::size_t SCREEN_WIDTH{40};
 
 using Screen = std::array<std::array<char, SCREEN_WIDTH>, 6>;
@@ -10,13 +13,13 @@ using Screen = std::array<std::array<char, SCREEN_WIDTH>, 6>;
 struct Instruction : Token_Reader<Instruction> {
 	enum class Type { NOOP, ADDX };
 
-	void read_token(const std::string &token) final {
-		switch (token_num()) {
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
 		case 0:
 			type_ = token == "noop" ? Type::NOOP : Type::ADDX;
 			break;
 		case 1:
-			value_ = std::stoi(token);
+			value_ = parse_number(token);
 			break;
 		}
 	}
@@ -62,23 +65,30 @@ static std::pair<int, Screen> run_cycles(const std::vector<Instruction> &instruc
 	return std::make_pair(sum, std::move(screen));
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Instruction> instructions;
-	while (has_input(std::cin))
-		instructions.push_back(Instruction::create_from_stream(std::cin));
-	const auto [signal_sum, screen] = run_cycles(instructions);
-	switch (part) {
-	case 1:
-		std::cout << signal_sum << std::endl;
-		break;
-	case 2:
-		for (const auto &row : screen) {
-			for (auto c : row)
-				std::cout << c;
-			std::cout << std::endl;
-		}
-		break;
+static std::string render(const Screen &screen) {
+	std::string image;
+	for (const auto &row : screen) {
+		if (!image.empty())
+			image.push_back('\n');
+		image.append(row.begin(), row.end());
+	}
+	return image;
+}
+
+struct Solution {
+	static std::vector<Instruction> parse(Input_Source &input) {
+		return read_records<Instruction>(input);
+	}
+
+	static int part1(const std::vector<Instruction> &instructions) {
+		return run_cycles(instructions).first;
+	}
+
+	static std::string part2(const std::vector<Instruction> &instructions) {
+		return render(run_cycles(instructions).second);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(10, Solution)
@@ -3,21 +3,23 @@
 #include <numeric>
 #include <vector>
 
+namespace {
+
 using Item_Type = unsigned long;
 
 struct Monkey : Paragraph_Reader<Monkey> {
 	enum class Operator { ADD, MULTIPLY };
 
-	void read_line(const std::string &line) final {
+	void read_line(std::size_t line_num, std::string_view line) {
 		const auto delim_pos = line.find(':');
-		switch (line_num()) {
+		switch (line_num) {
 		case 0:
-			id_ = std::stoi(line.substr(delim_pos - 1, delim_pos));
+			id_ = parse_number(line.substr(delim_pos - 1, delim_pos));
 			break;
 		case 1:
 			for (std::size_t delim_pos_old = delim_pos + 2, delim_pos_new = 0; delim_pos_new != std::string::npos; delim_pos_old = delim_pos_new + 2) {
 				delim_pos_new = line.find(',', delim_pos_old);
-				items_.push_back(std::stoi(line.substr(delim_pos_old, delim_pos_new - delim_pos_old)));
+				items_.push_back(parse_number(line.substr(delim_pos_old, delim_pos_new - delim_pos_old)));
 			}
 			break;
 		case 2:
@@ -31,20 +33,20 @@ struct Monkey : Paragraph_Reader<Monkey> {
 				throw std::logic_error{"No operator found"};
 
 			const auto value_str = line.substr(op_delim + 2);
-			operation_value_ = value_str == "old" ? 0 : std::stoi(value_str);
+			operation_value_ = value_str == "old" ? 0 : parse_number(value_str);
 			break;
 		}
 		case 3:
-			test_value_ = std::stoi(line.substr(line.find_last_of(' ') + 1));
+			test_value_ = parse_number(line.substr(line.find_last_of(' ') + 1));
 			break;
 		case 4:
-			monkey_if_true_ = std::stoi(line.substr(line.find_last_of(' ') + 1));
+			monkey_if_true_ = parse_number(line.substr(line.find_last_of(' ') + 1));
 			break;
 		case 5:
-			monkey_if_false_ = std::stoi(line.substr(line.find_last_of(' ') + 1));
+			monkey_if_false_ = parse_number(line.substr(line.find_last_of(' ') + 1));
 			break;
 		default:
-			throw std::logic_error{std::string{"Unexpected input line: "} + line};
+			throw std::logic_error{"Unexpected input line: " + std::string{line}};
 		}
 	}
 
@@ -114,18 +116,20 @@ static Item_Type calc_largest_modulus(const std::vector<Monkey> &monkeys) {
 						   [](auto sum, const auto &monkey) { return sum * monkey.test_value(); });
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Monkey> monkeys;
-	while (has_input(std::cin))
-		monkeys.push_back(Monkey::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << count_monkey_business(monkeys, 20, [](auto item) { return item / 3; }) << std::endl;
-		break;
-	case 2:
-		std::cout << count_monkey_business(monkeys, 10000, [mod = calc_largest_modulus(monkeys)](auto item) { return item % mod; }) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Monkey> parse(Input_Source &input) {
+		return read_records<Monkey>(input);
+	}
+
+	static Item_Type part1(std::vector<Monkey> monkeys) {
+		return count_monkey_business(monkeys, 20, [](auto item) { return item / 3; });
+	}
+
+	static Item_Type part2(std::vector<Monkey> monkeys) {
+		return count_monkey_business(monkeys, 10000, [mod = calc_largest_modulus(monkeys)](auto item) { return item % mod; });
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(11, Solution)
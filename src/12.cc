@@ -1,15 +1,18 @@
 #include "common.h"
+#include <array>
 #include <deque>
 #include <limits>
+#include <utility>
+
+namespace {
 
 static constexpr int INF{std::numeric_limits<int>::max()};
 
-[[nodiscard]] static Grid_Position find_location(const std::vector<std::vector<char>> &grid, char value) {
-	for (std::size_t r = 0; r < grid.size(); ++r) {
-		for (std::size_t c = 0; c < grid[r].size(); ++c) {
-			if (grid[r][c] == value)
-				return Grid_Position{r, c};
-		}
+[[nodiscard]] static Grid_Position find_location(const Grid<char> &grid, char value) {
+	for (std::size_t r = 0; r < grid.height(); ++r) {
+		const auto row = grid.row(r);
+		if (const auto it = std::ranges::find(row, value); it != row.end())
+			return Grid_Position{r, static_cast<std::size_t>(std::distance(row.begin(), it))};
 	}
 	throw std::logic_error{"Location not found"};
 }
@@ -18,71 +21,94 @@ static constexpr int INF{std::numeric_limits<int>::max()};
 	return to - from <= 1;
 }
 
+/*
+ * The cost grid shares the height grid's one-cell border, which is preset to cost 0 so that it can never be
+ * improved upon; neighbours are then reached by flat index offsets without any bounds checks.
+ */
 template<typename IsClimbableT>
-[[nodiscard]] static std::vector<std::vector<int>> shortest_path_costs(const std::vector<std::vector<char>> &grid, const Grid_Position &start,
-																	   const IsClimbableT &is_climbable) {
-	auto costs = std::vector<std::vector<int>>(grid.size(), std::vector<int>(grid[0].size(), INF));
-	costs[start.r][start.c] = 0;
-	for (std::deque<Grid_Position> to_visit{start}; !to_visit.empty(); ) {
-		const auto [row, col] = to_visit.front();
+[[nodiscard]] static Grid<int> shortest_path_costs(const Grid<char> &grid, const Grid_Position &start, const IsClimbableT &is_climbable) {
+	Grid<int> costs{grid.height(), grid.width(), INF, grid.padding(), 0};
+	const auto heights = grid.cells();
+	const auto cost_cells = costs.cells();
+	const auto stride = static_cast<std::ptrdiff_t>(grid.stride());
+	const std::array<std::ptrdiff_t, 4> nbr_offsets{-stride, stride, -1, 1};
+
+	const auto start_idx = grid.index(start);
+	cost_cells[start_idx] = 0;
+	for (std::deque<std::size_t> to_visit{start_idx}; !to_visit.empty(); ) {
+		const auto idx = to_visit.front();
 		to_visit.pop_front();
 
-		std::vector<Grid_Position> nbrs;
-		nbrs.reserve(4);
-		if (row > 0 && is_climbable(grid[row][col], grid[row - 1][col]))
-			nbrs.push_back(Grid_Position{row - 1, col});
-		if (row < grid.size() - 1 && is_climbable(grid[row][col], grid[row + 1][col]))
-			nbrs.push_back(Grid_Position{row + 1, col});
-		if (col > 0 && is_climbable(grid[row][col], grid[row][col - 1]))
-			nbrs.push_back(Grid_Position{row, col - 1});
-		if (col < grid[0].size() - 1 && is_climbable(grid[row][col], grid[row][col + 1]))
-			nbrs.push_back(Grid_Position{row, col + 1});
-		for (const auto &nbr : nbrs) {
-			if (costs[row][col] + 1 < costs[nbr.r][nbr.c]) {
-				costs[nbr.r][nbr.c] = costs[row][col] + 1;
-				to_visit.push_back(nbr);
+		const auto next_cost = cost_cells[idx] + 1;
+		for (auto offset : nbr_offsets) {
+			const auto nbr_idx = idx + offset;
+			if (next_cost < cost_cells[nbr_idx] && is_climbable(heights[idx], heights[nbr_idx])) {
+				cost_cells[nbr_idx] = next_cost;
+				to_visit.push_back(nbr_idx);
 			}
 		}
 	}
 	return costs;
 }
 
-[[nodiscard]] static int shortest_path_from_S(std::vector<std::vector<char>> grid) {
-	const auto start_pos = find_location(grid, 'S');
-	const auto end_pos = find_location(grid, 'E');
-	grid[start_pos.r][start_pos.c] = 'a';
-	grid[end_pos.r][end_pos.c] = 'z';
-	auto costs = shortest_path_costs(grid, start_pos, [](auto from, auto to) { return climbable(from, to); });
-	return costs[end_pos.r][end_pos.c];
+/*
+ * The height grid with S and E replaced by their elevations.
+ */
+struct Heightmap {
+	Grid<char> grid;
+	Grid_Position start, end;
+};
+
+[[nodiscard]] static Heightmap read_heightmap(Input_Source &in) {
+	auto grid = read_grid(in, [](char c) { return c; }, 1);
+	const auto start = find_location(grid, 'S');
+	const auto end = find_location(grid, 'E');
+	grid[start] = 'a';
+	grid[end] = 'z';
+	return Heightmap{std::move(grid), start, end};
+}
+
+/*
+ * Fewest steps from every square to E, found by walking downhill from E. This one search answers both parts.
+ */
+[[nodiscard]] static Grid<int> costs_to_end(const Heightmap &heightmap) {
+	return shortest_path_costs(heightmap.grid, heightmap.end, [](auto from, auto to) { return climbable(to, from); });
 }
 
-[[nodiscard]] static int shortest_path_from_any_a(std::vector<std::vector<char>> grid) {
-	const auto pos_S = find_location(grid, 'S');
-	const auto pos_E = find_location(grid, 'E');
-	grid[pos_S.r][pos_S.c] = 'a';
-	grid[pos_E.r][pos_E.c] = 'z';
-	auto costs = shortest_path_costs(grid, pos_E, [](auto from, auto to) { return climbable(to, from); });
+[[nodiscard]] static int shortest_path_from_S(const Heightmap &heightmap, const Grid<int> &costs) {
+	return costs[heightmap.start];
+}
 
+[[nodiscard]] static int shortest_path_from_any_a(const Heightmap &heightmap, const Grid<int> &costs) {
 	auto min_cost{INF};
-	for (std::size_t r = 0; r < grid.size(); ++r) {
-		for (std::size_t c = 0; c < grid[r].size(); ++c) {
-			if (grid[r][c] == 'a' && costs[r][c] < min_cost)
-				min_cost = costs[r][c];
+	for (std::size_t r = 0; r < heightmap.grid.height(); ++r) {
+		for (std::size_t c = 0; c < heightmap.grid.width(); ++c) {
+			if (heightmap.grid(r, c) == 'a' && costs(r, c) < min_cost)
+				min_cost = costs(r, c);
 		}
 	}
 	return min_cost;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	auto grid = read_grid(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << shortest_path_from_S(std::move(grid)) << std::endl;
-		break;
-	case 2:
-		std::cout << shortest_path_from_any_a(std::move(grid)) << std::endl;
-		break;
+struct Solution {
+	static Heightmap parse(Input_Source &input) {
+		return read_heightmap(input);
 	}
-	return 0;
+
+	static int part1(const Heightmap &heightmap) {
+		return shortest_path_from_S(heightmap, costs_to_end(heightmap));
+	}
+
+	static int part2(const Heightmap &heightmap) {
+		return shortest_path_from_any_a(heightmap, costs_to_end(heightmap));
+	}
+
+	static std::pair<int, int> both(const Heightmap &heightmap) {
+		const auto costs = costs_to_end(heightmap);
+		return std::make_pair(shortest_path_from_S(heightmap, costs), shortest_path_from_any_a(heightmap, costs));
+	}
+};
+
 }
+
+AOC_SOLUTION(12, Solution)
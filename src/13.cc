@@ -1,6 +1,8 @@
 #include "common.h"
 #include <variant>
 
+namespace {
+
 struct Packet {
 	using Item_Variant_Type = std::variant<Packet, int>;
 
@@ -10,7 +12,7 @@ struct Packet {
 		items_.push_back(std::move(item));
 	}
 
-	explicit Packet(const std::string &str)
+	explicit Packet(std::string_view str)
 			: Packet{str, 0} {}	
 
 	[[nodiscard]] bool operator==(const Packet &other) const noexcept {
@@ -62,25 +64,25 @@ private:
 
 	std::vector<Item_Variant_Type> items_;
 
-	Packet(const std::string &str, std::size_t pos)
+	Packet(std::string_view str, std::size_t pos)
 			: Packet{str, pos, true} {}
 
-	Packet(const std::string &str, std::size_t &pos, bool) {
-		auto int_start = std::string::npos;
+	Packet(std::string_view str, std::size_t &pos, bool) {
+		auto int_start = std::string_view::npos;
 		for (++pos; pos < str.size() && str[pos] != ']'; ++pos) {
 			if (str[pos] == '[') {
 				items_.emplace_back(Packet{str, pos, true});
 			} else if (str[pos] == ',') {
-				if (int_start != std::string::npos) {
-					items_.emplace_back(std::stoi(str.substr(int_start, pos - int_start)));
-					int_start = std::string::npos;
+				if (int_start != std::string_view::npos) {
+					items_.emplace_back(parse_number(str.substr(int_start, pos - int_start)));
+					int_start = std::string_view::npos;
 				}
-			} else if (int_start == std::string::npos) {
+			} else if (int_start == std::string_view::npos) {
 				int_start = pos;
 			}
 		}
-		if (int_start != std::string::npos)
-			items_.emplace_back(std::stoi(str.substr(int_start, pos - int_start)));
+		if (int_start != std::string_view::npos)
+			items_.emplace_back(parse_number(str.substr(int_start, pos - int_start)));
 	}
 };
 
@@ -100,8 +102,8 @@ std::ostream &operator<<(std::ostream &out, const Packet &packet) {
 
 struct Packet_Pair : Paragraph_Reader<Packet_Pair> {
 
-	void read_line(const std::string &line) final {
-		switch (line_num()) {
+	void read_line(std::size_t line_num, std::string_view line) {
+		switch (line_num) {
 		case 0: left_ = Packet{line}; break;
 		case 1: right_ = Packet{line}; break;
 		}
@@ -158,18 +160,20 @@ static int find_decoder_key(std::vector<Packet> packets) {
 	return key;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Packet_Pair> packet_pairs;
-	while (has_input(std::cin))
-		packet_pairs.push_back(Packet_Pair::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << sum_in_order_indices(packet_pairs) << std::endl;
-		break;
-	case 2:
-		std::cout << find_decoder_key(flatten_pairs(std::move(packet_pairs))) << std::endl;
-		break;
-	}
-	return 0;
+struct Solution {
+	static std::vector<Packet_Pair> parse(Input_Source &input) {
+		return read_records<Packet_Pair>(input);
+	}
+
+	static int part1(const std::vector<Packet_Pair> &packet_pairs) {
+		return sum_in_order_indices(packet_pairs);
+	}
+
+	static int part2(std::vector<Packet_Pair> packet_pairs) {
+		return find_decoder_key(flatten_pairs(std::move(packet_pairs)));
+	}
+};
+
 }
+
+AOC_SOLUTION(13, Solution)
@@ -1,36 +1,31 @@
 #include "common.h"
 #include <cmath>
 
-static Position read_position(const std::string &str) {
+namespace {
+
+using Rock_Path = std::vector<Position>;
+
+static Position read_position(std::string_view str) {
 	const auto delim_pos = str.find(',');
-	return Position{std::stoi(str.substr(0, delim_pos)), std::stoi(str.substr(delim_pos + 1))};
+	return Position{parse_number(str.substr(0, delim_pos)), parse_number(str.substr(delim_pos + 1))};
 }
 
-static std::vector<Position> read_positions(std::istream &in) {
-	std::vector<Position> positions;
-	std::stringstream ss{read_line(in)};
-	for (std::string token; std::getline(ss, token, ' '); ) {
+static Rock_Path read_positions(Input_Source &in) {
+	Rock_Path positions;
+	for_each_token(read_line(in), ' ', [&positions](auto token) {
 		if (token != "->")
 			positions.push_back(read_position(token));
-	}
+	});
 	return positions;
 }
 
-static void draw_rock(std::vector<std::vector<char>> &grid, const Position &position) {
-	if (static_cast<std::size_t>(position.y) >= grid.size())
-		grid.resize(position.y + 1);
-	auto max_length = std::max(static_cast<std::size_t>(position.x + 1),
-							   std::max_element(grid.begin(), grid.end(),
-								   				[](const auto &row0, const auto &row1) { return row0.size() < row1.size(); })->size());
-	for (auto &row : grid)
-		row.resize(max_length, '.');
-	grid[position.y][position.x] = '#';
+static void draw_rock(Grid<char> &grid, const Position &position) noexcept {
+	grid(position.y, position.x) = '#';
 }
 
-static void draw_rocks(std::vector<std::vector<char>> &grid, std::istream &in) {
-	auto positions = read_positions(in);
-	draw_rock(grid, positions.front());
-	for (auto position_it = std::next(positions.begin()); position_it != positions.end(); ++position_it) {
+static void draw_rocks(Grid<char> &grid, const Rock_Path &path) {
+	draw_rock(grid, path.front());
+	for (auto position_it = std::next(path.begin()); position_it != path.end(); ++position_it) {
 		if (position_it->x == std::prev(position_it)->x) {
 			const auto dist = position_it->y - std::prev(position_it)->y;
 			for (auto position = *std::prev(position_it); ; position.y += std::copysign(1, dist)) {
@@ -51,63 +46,93 @@ static void draw_rocks(std::vector<std::vector<char>> &grid, std::istream &in) {
 	}
 }
 
-static int drop_sand(std::vector<std::vector<char>> &grid) {
+static Grid<char> create_grid(const std::vector<Rock_Path> &paths, bool with_floor) {
+	int max_x{0}, max_y{0};
+	for (const auto &path : paths) {
+		for (const auto &position : path) {
+			max_x = std::max(max_x, position.x);
+			max_y = std::max(max_y, position.y);
+		}
+	}
+
+	std::size_t height = max_y + 1, width = max_x + 1;
+	if (with_floor) {
+		height = max_y + 3;
+		width = std::max<std::size_t>(width, 1000);
+	}
+	Grid<char> grid{height, width, '.'};
+	for (const auto &path : paths)
+		draw_rocks(grid, path);
+	if (with_floor)
+		std::ranges::fill(grid.row(height - 1), '#');
+	return grid;
+}
+
+static int drop_sand(Grid<char> &grid) {
 	static constexpr int source_x{500}, source_y{0};
+	const auto height = static_cast<int>(grid.height()), width = static_cast<int>(grid.width());
 	int unit_num;
-	for (unit_num = 0; grid[source_y][source_x] == '.'; ++unit_num) {
+	for (unit_num = 0; grid(source_y, source_x) == '.'; ++unit_num) {
 		Position sand{source_x, source_y};
 		for (;; ++sand.y) {
-			if (sand.y + 1 == static_cast<int>(grid.size()))
+			if (sand.y + 1 == height)
 				return unit_num;
-			if (grid[sand.y + 1][sand.x] != '.') {
+			if (grid(sand.y + 1, sand.x) != '.') {
 				if (sand.x - 1 < 0)
 					return unit_num;
-				else if (grid[sand.y + 1][sand.x - 1] == '.')
+				else if (grid(sand.y + 1, sand.x - 1) == '.')
 					--sand.x;
-				else if (sand.x + 1 == static_cast<int>(grid[sand.y].size()))
+				else if (sand.x + 1 == width)
 					return unit_num;
-				else if (grid[sand.y + 1][sand.x + 1] == '.')
+				else if (grid(sand.y + 1, sand.x + 1) == '.')
 					++sand.x;
 				else
 					break;
 			}
 		}
-		grid[sand.y][sand.x] = '*';
+		grid(sand.y, sand.x) = '*';
 	}
 	return unit_num;
 }
 
-static std::size_t first_horizontal_rock_position(const std::vector<std::vector<char>> &grid) {
+static std::size_t first_horizontal_rock_position(const Grid<char> &grid) {
 	std::size_t position{std::numeric_limits<std::size_t>::max()};
-	for (const auto &row : grid)
-		position = std::min(position, static_cast<std::size_t>(std::distance(row.begin(), std::find_if_not(row.begin(), row.end(),
-																										   [](auto c) { return c == '.'; }))));
+	for (std::size_t r = 0; r < grid.height(); ++r) {
+		const auto row = grid.row(r);
+		position = std::min(position, static_cast<std::size_t>(std::distance(row.begin(),
+																			 std::ranges::find_if_not(row, [](auto c) { return c == '.'; }))));
+	}
 	return position;
 }
 
-[[maybe_unused]] static void draw_grid(const std::vector<std::vector<char>> &grid) {
+[[maybe_unused]] static void draw_grid(const Grid<char> &grid) {
 	const auto first_position = first_horizontal_rock_position(grid);
-	for (const auto &row : grid) {
-		for (std::size_t i = first_position; i < row.size(); ++i)
-			std::cout << row[i];
+	for (std::size_t r = 0; r < grid.height(); ++r) {
+		for (std::size_t c = first_position; c < grid.width(); ++c)
+			std::cout << grid(r, c);
 		std::cout << std::endl;
 	}
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<std::vector<char>> grid;
-	while (has_input(std::cin))
-		draw_rocks(grid, std::cin);
-	switch (part) {
-	case 1:
-		std::cout << drop_sand(grid) << std::endl;
-		break;
-	case 2:
-		for (Position position{0, static_cast<int>(grid.size()) + 1}; position.x < 1000; ++position.x)
-			draw_rock(grid, position);
-		std::cout << drop_sand(grid) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Rock_Path> parse(Input_Source &input) {
+		std::vector<Rock_Path> paths;
+		while (has_input(input))
+			paths.push_back(read_positions(input));
+		return paths;
+	}
+
+	static int part1(const std::vector<Rock_Path> &paths) {
+		auto grid = create_grid(paths, false);
+		return drop_sand(grid);
 	}
-	return 0;
+
+	static int part2(const std::vector<Rock_Path> &paths) {
+		auto grid = create_grid(paths, true);
+		return drop_sand(grid);
+	}
+};
+
 }
+
+AOC_SOLUTION(14, Solution)
@@ -1,12 +1,14 @@
 #include "common.h"
 
+namespace {
+
 struct Sensor_Info : Line_Reader<Sensor_Info> {
 
-	void read_line(const std::string &line) final {
+	void read_line(std::string_view line) {
 		const auto sensor_start = line.find("x=");
 		const auto sensor_end = line.find(':', sensor_start);
 		position_ = read_position(line, sensor_start, sensor_end);
-		beacon_position_ = read_position(line, line.find("x=", sensor_end), std::string::npos);
+		beacon_position_ = read_position(line, line.find("x=", sensor_end), std::string_view::npos);
 		range_ = manhattan_distance(position_, beacon_position_);
 	}
 
@@ -35,10 +37,10 @@ private:
 		return std::abs(lhs.x - rhs.x) + std::abs(lhs.y - rhs.y);
 	}
 
-	[[nodiscard]] static Position read_position(const std::string &line, std::size_t start, std::size_t end) {
+	[[nodiscard]] static Position read_position(std::string_view line, std::size_t start, std::size_t end) {
 		const auto delim_pos = line.find(',', start);
-		return Position{std::stoi(line.substr(start + 2, delim_pos)),
-				std::stoi(line.substr(delim_pos + 4, end))};
+		return Position{parse_number(line.substr(start + 2, delim_pos)),
+				parse_number(line.substr(delim_pos + 4, end))};
 	}
 
 	Position position_{};
@@ -76,18 +78,20 @@ static long tuning_frequency(const Position &position) {
 	return position.x * 4000000l + position.y;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Sensor_Info> sensors;
-	while (has_input(std::cin))
-		sensors.push_back(Sensor_Info::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << num_blind_spots(sensors, 2000000) << std::endl;
-		break;
-	case 2:
-		std::cout << tuning_frequency(beacon_position(sensors, 0, 0, 4000000, 4000000)) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Sensor_Info> parse(Input_Source &input) {
+		return read_records<Sensor_Info>(input);
+	}
+
+	static int part1(const std::vector<Sensor_Info> &sensors) {
+		return num_blind_spots(sensors, 2000000);
+	}
+
+	static long part2(const std::vector<Sensor_Info> &sensors) {
+		return tuning_frequency(beacon_position(sensors, 0, 0, 4000000, 4000000));
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(15, Solution)
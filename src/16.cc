@@ -1,28 +1,40 @@
 #include "common.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
 #include <deque>
+#include <functional>
+#include <exception>
+#include <future>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
 #include <unordered_map>
-#include <unordered_set>
+
+namespace {
 
 struct Valve_Info : Line_Reader<Valve_Info> {
 
-	void read_line(const std::string &line) final {
+	void read_line(std::string_view line) {
 		const auto name_start = line.find(' ') + 1;
 		const auto name_end = line.find(' ', name_start);
 		name_ = line.substr(name_start, name_end - name_start);
 
 		const auto rate_start = line.find('=') + 1;
 		const auto rate_end = line.find(';', rate_start);
-		rate_ = std::stoi(line.substr(rate_start, rate_end - rate_start));
+		rate_ = parse_number(line.substr(rate_start, rate_end - rate_start));
 
 		const auto nbrs_start = line.find("valve");
 		for (auto nbr_start = line.find(' ', nbrs_start) + 1;;) {
 			auto delim_pos = line.find(',', nbr_start);
-			if (delim_pos == std::string::npos) {
-				neighbors_.push_back(line.substr(nbr_start));
+			if (delim_pos == std::string_view::npos) {
+				neighbors_.emplace_back(line.substr(nbr_start));
 				break;
 			}
-			neighbors_.push_back(line.substr(nbr_start, delim_pos - nbr_start));
+			neighbors_.emplace_back(line.substr(nbr_start, delim_pos - nbr_start));
 			nbr_start = delim_pos + 2;
 		}
 	}
@@ -74,10 +86,10 @@ private:
 
 using Valve_Graph = std::unordered_map<std::string, std::unique_ptr<Valve>>;
 
-static Valve_Graph create_valve_graph(std::istream &in) {
+static Valve_Graph create_valve_graph(Input_Source &in) {
 	std::vector<Valve_Info> valve_infos;
 	while (has_input(in))
-		valve_infos.push_back(Valve_Info::create_from_stream(in));
+		valve_infos.push_back(Valve_Info::create_from_input(in));
 
 	Valve_Graph valves;
 	valves.reserve(valve_infos.size());
@@ -90,164 +102,444 @@ static Valve_Graph create_valve_graph(std::istream &in) {
 	return valves;
 }
 
-struct Node {
-	struct Mover {
-		Mover(const Valve &from, const Valve &to) noexcept
-			: from_{&from}, to_{&to} { }
+/*
+ * The tunnel network collapsed onto the valves worth opening. Flowing valve i is bit i of an opened-valve mask, the
+ * start valve takes the index after the last flowing valve, and distances holds the shortest walk between every pair.
+ * by_rate and min_distance (the shortest walk between two flowing valves) feed the search's optimistic bound.
+ */
+struct Valve_Network {
+	std::vector<int> rates;
+	std::vector<std::uint8_t> distances;
+	std::vector<std::size_t> by_rate;
+	int min_distance{std::numeric_limits<std::uint8_t>::max()};
+
+	[[nodiscard]] std::size_t num_valves() const noexcept {
+		return rates.size();
+	}
 
-		[[nodiscard]] const Valve &from() const noexcept {
-			return *from_;
-		}
+	[[nodiscard]] std::size_t start() const noexcept {
+		return rates.size();
+	}
 
-		[[nodiscard]] const Valve &to() const noexcept {
-			return *to_;
-		}
+	[[nodiscard]] int distance(std::size_t from, std::size_t to) const noexcept {
+		return distances[from * (rates.size() + 1) + to];
+	}
+};
 
-		[[nodiscard]] bool operator==(const Mover &other) const noexcept {
-			return from_ == other.from_ && to_ == other.to_;
-		}
-	private:
-		const Valve *from_, *to_;
-	};
+using Valve_Mask = std::uint64_t;
 
-	Node(std::vector<Mover> movers, int time_remaining, int pressure, std::unordered_set<const Valve *> opened_valves = {})
-			: movers_{std::move(movers)},
-			  time_remaining_{time_remaining},
-			  pressure_{pressure},
-			  opened_valves_{std::move(opened_valves)} {
-		std::sort(movers_.begin(), movers_.end(), [](const auto &lhs, const auto &rhs) {
-			return lhs.from().name() < rhs.from().name() || (lhs.from().name() == rhs.from().name() && lhs.to().name() < rhs.to().name());
-		});
-	}
+static constexpr std::size_t MAX_FLOWING_VALVES{48};
 
-	[[nodiscard]] const std::vector<Mover> &movers() const noexcept {
-		return movers_;
+static Valve_Network compress_valve_graph(const Valve_Graph &valve_graph, const std::string &start_valve) {
+	std::vector<const Valve *> valves;
+	for (const auto &[name, valve] : valve_graph) {
+		if (valve->rate() > 0)
+			valves.push_back(valve.get());
 	}
-
-	[[nodiscard]] const Valve &from() const noexcept {
-		return movers_[0].from();
+	if (valves.size() > MAX_FLOWING_VALVES)
+		throw std::runtime_error{"Too many flowing valves: " + std::to_string(valves.size())};
+	std::sort(valves.begin(), valves.end(), [](auto lhs, auto rhs) { return lhs->name() < rhs->name(); });
+	valves.push_back(valve_graph.at(start_valve).get());
+
+	Valve_Network network;
+	for (std::size_t i = 0; i + 1 < valves.size(); ++i)
+		network.rates.push_back(valves[i]->rate());
+	network.distances.resize(valves.size() * valves.size(), std::numeric_limits<std::uint8_t>::max());
+	for (std::size_t from = 0; from < valves.size(); ++from) {
+		std::unordered_map<const Valve *, int> steps{{valves[from], 0}};
+		std::deque<const Valve *> to_visit{valves[from]};
+		while (!to_visit.empty()) {
+			const auto valve = to_visit.front();
+			to_visit.pop_front();
+			for (auto nbr_ptr : valve->neighbors()) {
+				if (steps.emplace(nbr_ptr, steps[valve] + 1).second)
+					to_visit.push_back(nbr_ptr);
+			}
+		}
+		for (std::size_t to = 0; to < valves.size(); ++to) {
+			if (auto it = steps.find(valves[to]); it != steps.end())
+				network.distances[from * valves.size() + to] = std::min(it->second, int{std::numeric_limits<std::uint8_t>::max()});
+		}
 	}
 
-	[[nodiscard]] const Valve &to() const noexcept {
-		return movers_[0].to();
+	for (std::size_t valve = 0; valve < network.num_valves(); ++valve) {
+		network.by_rate.push_back(valve);
+		for (std::size_t other = 0; other < network.num_valves(); ++other) {
+			if (other != valve)
+				network.min_distance = std::min(network.min_distance, network.distance(valve, other));
+		}
 	}
+	std::stable_sort(network.by_rate.begin(), network.by_rate.end(), [&network](auto lhs, auto rhs) {
+		return network.rates[lhs] > network.rates[rhs];
+	});
+	return network;
+}
 
-	[[nodiscard]] int time_remaining() const noexcept {
-		return time_remaining_;
-	}
+/*
+ * A search state packed into one word: the opened valves above the acting mover, which is
+ * (movers still to act << 13 | time left << 7 | valve). Movers only interact through the valves they open, so rather
+ * than interleaving them, each mover plans its whole route in turn and then hands the unopened valves to the next.
+ */
+using Search_State = std::uint64_t;
 
-	[[nodiscard]] int pressure() const noexcept {
-		return pressure_;
-	}
+static constexpr int MAX_TIME{63};
+static constexpr std::size_t MAX_MOVERS{8};
+
+[[nodiscard]] static constexpr Search_State pack_state(Valve_Mask opened, std::size_t movers_left, int time, std::size_t valve) noexcept {
+	return opened << 16 | movers_left << 13 | static_cast<Search_State>(time) << 7 | valve;
+}
 
-	[[nodiscard]] std::size_t num_opened() const noexcept {
-		return opened_valves_.size();
+/*
+ * Branch-and-bound over "walk to an unopened valve and open it" moves. At any point the acting mover may instead stop,
+ * and the next mover sets off from the start with the full time. States within SPLIT_DEPTH opened valves of the start
+ * are submitted to a work-stealing pool and everything deeper is searched depth-first by the worker that holds it.
+ * The workers share a sharded table of the most pressure any of them has reached each state with, which prunes
+ * dominated arrivals, and the best total found so far, which prunes states whose optimistic bound cannot beat it.
+ */
+struct Parallel_Pressure_Search {
+	Parallel_Pressure_Search(const Valve_Network &network, int total_time, std::size_t num_threads)
+		: network_{network},
+		  total_time_{total_time},
+		  pool_{num_threads} { }
+
+	/*
+	 * The best total from the start state. If any task throws, the first exception is rethrown here once every task
+	 * still queued has finished.
+	 */
+	int run(Search_State start) {
+		auto done = done_.get_future();
+		spawn(start, 0);
+		done.get();
+		return best_.load();
 	}
 
-	[[nodiscard]] const std::unordered_set<const Valve *> &opened_valves() const noexcept {
-		return opened_valves_;
+private:
+	static constexpr std::size_t NUM_SHARDS{64};
+	static constexpr int SPLIT_DEPTH{2};
+
+	struct alignas(64) Shard {
+		std::mutex mutex;
+		Flat_Hash_Map<Search_State, int, Mixed_Key_Hash> best;
+	};
+
+	const Valve_Network &network_;
+	int total_time_;
+	std::array<Shard, NUM_SHARDS> shards_;
+	std::atomic<int> best_{0};
+	std::atomic<std::size_t> outstanding_{0};
+	std::atomic<bool> failed_{false};
+	std::exception_ptr error_;
+	std::promise<void> done_;
+	// Declared last so the workers are joined before anything they use is destroyed
+	Thread_Pool pool_;
+
+	/*
+	 * Queues a state as a task. Every task counts down outstanding_ however it ends, and the last one completes done_,
+	 * with the first exception any task threw. Once one has, the rest return without searching.
+	 */
+	void spawn(Search_State state, int pressure) {
+		outstanding_.fetch_add(1);
+		try {
+			static_cast<void>(pool_.submit([this, state, pressure] {
+				try {
+					explore(state, pressure);
+				} catch (...) {
+					if (!failed_.exchange(true))
+						error_ = std::current_exception();
+				}
+				if (outstanding_.fetch_sub(1) == 1) {
+					if (error_)
+						done_.set_exception(error_);
+					else
+						done_.set_value();
+				}
+			}));
+		} catch (...) {
+			outstanding_.fetch_sub(1);
+			throw;
+		}
 	}
 
-	[[nodiscard]] bool in_open_set(const Valve &valve) const {
-		return opened_valves_.contains(&valve);
-	}	
+	void explore(Search_State state, int pressure) {
+		if (failed_.load(std::memory_order_relaxed))
+			return;
+		AOC_COUNT("max_pressure: nodes expanded", 1);
+		raise_best(pressure);
+		const Valve_Mask opened{state >> 16};
+		const auto movers_left = state >> 13 & 0x7;
+		const auto time = static_cast<int>(state >> 7 & 0x3f);
+		const auto from = state & 0x7f;
+		if (pressure + optimistic_bound(opened, movers_left, time, from) <= best_.load(std::memory_order_relaxed)) {
+			AOC_COUNT("max_pressure: bound prunes", 1);
+			return;
+		}
+		if (!improves(state, pressure)) {
+			AOC_COUNT("max_pressure: dominance prunes", 1);
+			return;
+		}
 
-	[[nodiscard]] bool operator==(const Node &other) const noexcept {
-		return movers_ == other.movers_ && num_opened() == other.num_opened();
+		// Most promising moves first, so good totals are found early and prune more
+		std::array<std::pair<Search_State, int>, MAX_FLOWING_VALVES + 1> moves;
+		std::size_t num_moves{0};
+		if (movers_left > 0)
+			moves[num_moves++] = std::make_pair(pack_state(opened, movers_left - 1, total_time_, network_.start()), pressure);
+		for (std::size_t valve = 0; valve < network_.num_valves(); ++valve) {
+			if (opened >> valve & 1)
+				continue;
+			const auto time_left = time - network_.distance(from, valve) - 1;
+			if (time_left > 0)
+				moves[num_moves++] = std::make_pair(pack_state(opened | Valve_Mask{1} << valve, movers_left, time_left, valve), pressure + network_.rates[valve] * time_left);
+		}
+		std::sort(moves.begin(), moves.begin() + num_moves, [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
+
+		const auto split = std::popcount(opened) < SPLIT_DEPTH;
+		for (std::size_t i = 0; i < num_moves; ++i) {
+			if (split)
+				spawn(moves[i].first, moves[i].second);
+			else
+				explore(moves[i].first, moves[i].second);
+		}
 	}
 
-private:	
-	std::vector<Mover> movers_;
-	int time_remaining_;
-	int pressure_;
-	std::unordered_set<const Valve *> opened_valves_;
-};
+	/*
+	 * Upper bound on the pressure still to come: the closed valves taken in descending rate order, each opened at the
+	 * latest time left to any mover if every walk were as short as the nearest closed valve for the first and as the
+	 * closest pair of flowing valves after that.
+	 */
+	[[nodiscard]] int optimistic_bound(Valve_Mask opened, std::size_t movers_left, int time, std::size_t from) const noexcept {
+		int nearest{std::numeric_limits<std::uint8_t>::max()}, nearest_to_start{std::numeric_limits<std::uint8_t>::max()};
+		for (std::size_t valve = 0; valve < network_.num_valves(); ++valve) {
+			if (!(opened >> valve & 1)) {
+				nearest = std::min(nearest, network_.distance(from, valve));
+				nearest_to_start = std::min(nearest_to_start, network_.distance(network_.start(), valve));
+			}
+		}
+		// The next time each mover could open a valve: the acting one, then those still to set off
+		std::array<int, MAX_MOVERS> open_times;
+		open_times[0] = time - nearest - 1;
+		std::fill(open_times.begin() + 1, open_times.begin() + movers_left + 1, total_time_ - nearest_to_start - 1);
+
+		int bound{0};
+		for (auto valve : network_.by_rate) {
+			if (opened >> valve & 1)
+				continue;
+			const auto latest = std::max_element(open_times.begin(), open_times.begin() + movers_left + 1);
+			if (*latest <= 0)
+				break;
+			bound += network_.rates[valve] * *latest;
+			*latest -= network_.min_distance + 1;
+		}
+		return bound;
+	}
 
-struct Node_Hasher {
-	[[nodiscard]] std::size_t operator()(const Node &node) const noexcept {
-		std::string hash_str;
-		for (const auto &mover : node.movers())
-			hash_str += mover.from().name() + "->" + mover.to().name() + ",";
-		return std::hash<std::string>{}(hash_str + ":" + std::to_string(node.num_opened()));
+	/*
+	 * Records the pressure a state was reached with, returning false if it was already reached with at least as much.
+	 */
+	bool improves(Search_State state, int pressure) {
+		// The tables index by the low hash bits, so pick the shard by the high ones
+		auto &shard = shards_[mix_hash(state) >> 58];
+		std::lock_guard lock{shard.mutex};
+		const auto [it, inserted] = shard.best.insert(std::make_pair(state, pressure));
+		if (inserted)
+			return true;
+		if (it->second >= pressure)
+			return false;
+		it->second = pressure;
+		return true;
 	}
-};
 
-struct Mover_Option {
-	const Valve *from, *to;
-	int pressure_inc;
-	std::unordered_set<const Valve *> opened_valves;
+	void raise_best(int pressure) noexcept {
+		auto current = best_.load(std::memory_order_relaxed);
+		while (pressure > current) {
+			if (best_.compare_exchange_weak(current, pressure, std::memory_order_relaxed)) {
+				AOC_COUNT("max_pressure: incumbent updates", 1);
+				break;
+			}
+		}
+	}
 };
 
-static int max_pressure(const Valve_Graph &valve_graph, const std::string &start_valve, int total_time, std::size_t num_movers) {
-	Node start_node{std::vector<Node::Mover>(num_movers, Node::Mover{*valve_graph.at(start_valve), *valve_graph.at(start_valve)}), total_time, 0};
-	std::unordered_set<Node, Node_Hasher> max_nodes{start_node};
-	std::deque<Node> to_visit{std::move(start_node)};
-	while (!to_visit.empty()) {
-		auto node = to_visit.front();
-		to_visit.pop_front();
-
-		const auto next_time = node.time_remaining() - 1;
-		if (next_time <= 0)
+/*
+ * Records in routes the most pressure one mover releases by opening exactly each set of valves, over every route from
+ * the given valve. Routes is either a table over every set or a hash map holding only the sets some route opens.
+ */
+template<typename RoutesT>
+static void record_routes(const Valve_Network &network, std::size_t from, int time, Valve_Mask opened, int pressure, RoutesT &routes) {
+	AOC_COUNT("max_pressure: routes", 1);
+	routes[opened] = std::max(routes[opened], pressure);
+	for (std::size_t valve = 0; valve < network.num_valves(); ++valve) {
+		if (opened >> valve & 1)
 			continue;
+		const auto time_left = time - network.distance(from, valve) - 1;
+		if (time_left > 0)
+			record_routes(network, valve, time_left, opened | Valve_Mask{1} << valve, pressure + network.rates[valve] * time_left, routes);
+	}
+}
 
-		std::vector<std::vector<Mover_Option>> mover_options(node.movers().size());
-		for (std::size_t mi = 0; mi < node.movers().size(); ++mi) {
-			const auto &mover = node.movers()[mi];
-			if (!node.in_open_set(mover.to()))
-				mover_options[mi].push_back(Mover_Option{&mover.to(), &mover.to(), mover.to().rate() * next_time, {&mover.to()}});
-			for (auto nbr_ptr : mover.to().neighbors())
-				mover_options[mi].push_back(Mover_Option{&mover.to(), nbr_ptr, 0, {}});
+/*
+ * Raises every set's value to the best value of any of its subsets, one valve bit at a time.
+ */
+static void superset_max_transform(std::vector<int> &values, std::size_t num_valves) {
+	for (std::size_t valve = 0; valve < num_valves; ++valve) {
+		const Valve_Mask bit{Valve_Mask{1} << valve};
+		for (Valve_Mask valves = 0; valves < values.size(); ++valves) {
+			if (valves & bit)
+				values[valves] = std::max(values[valves], values[valves ^ bit]);
 		}
+	}
+}
 
-		for (std::vector<std::size_t> mover_indices(mover_options.size(), 0); mover_indices.front() < mover_options.front().size(); ) {
-			std::vector<Node::Mover> movers;
-			int pressure{node.pressure()};
-			auto opened_valves = node.opened_valves();
-			for (std::size_t i = 0; i < mover_indices.size(); ++i) {
-				const auto &options = mover_options[i][mover_indices[i]];
-				movers.emplace_back(*options.from, *options.to);
-				for (auto valve_ptr : options.opened_valves) {
-					if (opened_valves.emplace(valve_ptr).second)
-						pressure += valve_ptr->rate() * next_time;
-				}
-			}
-			Node next_node{std::move(movers), next_time, pressure, std::move(opened_valves)};
-
-			auto max_it = max_nodes.find(next_node);
-			if (max_it == max_nodes.end() || next_node.pressure() > max_it->pressure()) {
-				if (max_it != max_nodes.end())
-					max_nodes.erase(max_it);
-				max_nodes.insert(next_node);
-				to_visit.push_back(std::move(next_node));
+/*
+ * The dense subset DP only covers small networks: its tables hold an int for every set of flowing valves, and each
+ * mover past the second merges every route with every superset of it, about 3^n steps for n valves. On larger
+ * networks one or two movers pair up the sets their routes open instead, which grows with the routes that fit in the
+ * time rather than with the valves.
+ */
+static constexpr std::size_t MAX_SUBSET_VALVES{16};
+
+[[nodiscard]] static bool fits_subset_dp(const Valve_Network &network, std::size_t num_movers) noexcept {
+	return network.num_valves() <= MAX_SUBSET_VALVES || num_movers <= 2;
+}
+
+/*
+ * Whether the subset DPs beat the search: always on small networks, and for two movers on any. A lone mover on a
+ * larger network is left to the search, whose bound prunes a single route far faster than every route can be listed.
+ */
+[[nodiscard]] static bool prefers_subset_dp(const Valve_Network &network, std::size_t num_movers) noexcept {
+	return network.num_valves() <= MAX_SUBSET_VALVES || num_movers == 2;
+}
+
+/*
+ * One or two movers on a network of any size (up to MAX_FLOWING_VALVES): only the sets of valves some route opens are recorded, each with the
+ * most pressure one mover releases opening exactly them, and two movers take the best pair of disjoint sets. With the
+ * sets ordered by pressure, each is only paired down the list while the pair could still beat the best found.
+ */
+static int route_pair_max_pressure(const Valve_Network &network, int total_time, std::size_t num_movers) {
+	Flat_Hash_Map<Valve_Mask, int, Mixed_Key_Hash> routes;
+	record_routes(network, network.start(), total_time, 0, 0, routes);
+	std::vector<std::pair<int, Valve_Mask>> by_pressure;
+	by_pressure.reserve(routes.size());
+	for (const auto &[valves, pressure] : routes)
+		by_pressure.emplace_back(pressure, valves);
+	std::sort(by_pressure.begin(), by_pressure.end(), std::greater{});
+	AOC_GAUGE("max_pressure: route sets", by_pressure.size());
+
+	// The empty route is always recorded
+	auto best = by_pressure.front().first;
+	if (num_movers == 1)
+		return best;
+	for (std::size_t i = 0; i < by_pressure.size() && 2 * by_pressure[i].first > best; ++i) {
+		const auto [pressure, valves] = by_pressure[i];
+		for (auto j = i + 1; j < by_pressure.size() && pressure + by_pressure[j].first > best; ++j) {
+			if ((valves & by_pressure[j].second) == 0) {
+				best = pressure + by_pressure[j].first;
+				break;
 			}
+		}
+	}
+	return best;
+}
 
-			for (std::size_t i = mover_indices.size() - 1;;) {
-				if (++mover_indices[i] != mover_options[i].size())
-					break;
-				if (i == 0)
+/*
+ * Exact for any number of movers on networks of up to MAX_SUBSET_VALVES flowing valves: the best single-mover
+ * pressure is recorded for every set of opened valves, and movers are then added one at a time by splitting each set
+ * between the new mover's route and the best the movers so far manage on the rest. After the superset-max transform,
+ * movers_best[S] is the most the movers can release using only valves in S, so only the final split of all valves
+ * has to be searched for the last mover.
+ */
+static int dense_subset_max_pressure(const Valve_Network &network, int total_time, std::size_t num_movers) {
+	std::vector<int> routes(std::size_t{1} << network.num_valves(), 0);
+	record_routes(network, network.start(), total_time, 0, 0, routes);
+	std::vector<Valve_Mask> route_sets;
+	for (Valve_Mask valves = 1; valves < routes.size(); ++valves) {
+		if (routes[valves] > 0)
+			route_sets.push_back(valves);
+	}
+
+	auto movers_best = routes;
+	superset_max_transform(movers_best, network.num_valves());
+	const Valve_Mask all_valves{routes.size() - 1};
+	for (std::size_t movers = 2; movers < num_movers; ++movers) {
+		auto next_best = movers_best;
+		for (auto route : route_sets) {
+			// Every superset of the route, as route | (subset of the other valves)
+			const auto others = all_valves ^ route;
+			for (auto rest = others;; rest = (rest - 1) & others) {
+				next_best[route | rest] = std::max(next_best[route | rest], routes[route] + movers_best[rest]);
+				if (rest == 0)
 					break;
-				mover_indices[i] = 0;
-				--i;
 			}
 		}
+		movers_best = std::move(next_best);
 	}
+	if (num_movers == 1)
+		return movers_best[all_valves];
+
+	auto best = movers_best[all_valves];
+	for (auto route : route_sets)
+		best = std::max(best, routes[route] + movers_best[all_valves ^ route]);
+	return best;
+}
 
-	int max_val{0};
-	for (const auto &node : max_nodes)
-		max_val = std::max(max_val, node.pressure());
-	return max_val;
+static int subset_max_pressure(const Valve_Network &network, int total_time, std::size_t num_movers) {
+	return network.num_valves() <= MAX_SUBSET_VALVES ? dense_subset_max_pressure(network, total_time, num_movers)
+			: route_pair_max_pressure(network, total_time, num_movers);
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	auto valves = create_valve_graph(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << max_pressure(valves, "AA", 30, 1) << std::endl;
-		break;
-	case 2:
-		std::cout << max_pressure(valves, "AA", 26, 2) << std::endl;
-		break;
-	}
-	return 0;
+static int search_max_pressure(const Valve_Network &network, int total_time, std::size_t num_movers) {
+	Parallel_Pressure_Search search{network, total_time, default_thread_count()};
+	return search.run(pack_state(0, num_movers - 1, total_time, network.start()));
 }
+
+enum class Pressure_Backend { AUTO, SUBSET, SEARCH };
+
+/*
+ * $AOC_DAY16_BACKEND set to "subset" or "search" forces that backend, e.g. so the benchmarks can time the parallel
+ * search on the real input; unset or "auto" picks by network size.
+ */
+[[nodiscard]] static Pressure_Backend pressure_backend() {
+	const auto env = std::getenv("AOC_DAY16_BACKEND");
+	if (env == nullptr || *env == '\0' || std::string_view{env} == "auto")
+		return Pressure_Backend::AUTO;
+	if (std::string_view{env} == "subset")
+		return Pressure_Backend::SUBSET;
+	if (std::string_view{env} == "search")
+		return Pressure_Backend::SEARCH;
+	throw std::invalid_argument{std::string{"Unknown $AOC_DAY16_BACKEND: "} + env};
+}
+
+/*
+ * Uses the subset DPs where prefers_subset_dp() says they win, and the parallel search otherwise, unless
+ * pressure_backend() forces one.
+ */
+static int max_pressure(const Valve_Network &network, int total_time, std::size_t num_movers) {
+	AOC_TIMER("max_pressure");
+	if (num_movers == 0)
+		return 0;
+	const auto backend = pressure_backend();
+	if (backend == Pressure_Backend::SUBSET && !fits_subset_dp(network, num_movers))
+		throw std::invalid_argument{"Too many flowing valves for the subset DP with " + std::to_string(num_movers) + " movers: " + std::to_string(network.num_valves())};
+	if (backend == Pressure_Backend::SUBSET || (backend == Pressure_Backend::AUTO && prefers_subset_dp(network, num_movers)))
+		return subset_max_pressure(network, total_time, num_movers);
+	if (num_movers > MAX_MOVERS || total_time > MAX_TIME)
+		throw std::invalid_argument{"Unsupported search: " + std::to_string(num_movers) + " movers for " + std::to_string(total_time) + " minutes"};
+	return search_max_pressure(network, total_time, num_movers);
+}
+
+struct Solution {
+	static Valve_Network parse(Input_Source &input) {
+		return compress_valve_graph(create_valve_graph(input), "AA");
+	}
+
+	static int part1(const Valve_Network &network) {
+		return max_pressure(network, 30, 1);
+	}
+
+	static int part2(const Valve_Network &network) {
+		return max_pressure(network, 26, 2);
+	}
+};
+
+}
+
+AOC_SOLUTION(16, Solution)
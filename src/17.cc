@@ -1,76 +1,230 @@
 #include "common.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
 #include <vector>
 
+namespace {
+
 enum class Direction { LEFT, RIGHT };
 
-static constexpr int CHAMBER_WIDTH{7};
+/*
+ * The chamber is seven columns wide and held as one bitmask per row, bit 6 being the leftmost column. A rock is a
+ * stack of up to four row masks packed into 32 bits, its bottom row in the lowest byte, so a push is a shift of the
+ * whole stack tested against the walls and the four chamber rows it would cover in one compare.
+ */
+using Row_Mask = std::uint8_t;
+using Rock_Stack = std::uint32_t;
 
-using Chamber = std::vector<std::array<bool, CHAMBER_WIDTH>>;
+static constexpr Row_Mask FLOOR{0x7f};
+static constexpr Rock_Stack LEFT_WALL{0x40404040}, RIGHT_WALL{0x01010101};
 
-using Rock_Shape = std::vector<Position>;
+struct Rock_Shape {
+	Rock_Stack stack;  // as it appears, two columns from the left wall
+	int height;
+};
 
-static const std::vector<std::vector<Position>> ROCK_SHAPES{
-	Rock_Shape{{0, 0}, {1, 0}, {2, 0}, {3, 0}},
-	Rock_Shape{{1, 0}, {0, 1}, {1, 1}, {2, 1}, {1, 2}},
-	Rock_Shape{{0, 0}, {1, 0}, {2, 0}, {2, 1}, {2, 2}},
-	Rock_Shape{{0, 0}, {0, 1}, {0, 2}, {0, 3}},
-	Rock_Shape{{0, 0}, {1, 0}, {0, 1}, {1, 1}}
+static constexpr std::array ROCK_SHAPES{
+	Rock_Shape{0x0000001e, 1},  // ####
+	Rock_Shape{0x00081c08, 3},  // +
+	Rock_Shape{0x0004041c, 3},  // backwards L
+	Rock_Shape{0x10101010, 4},  // |
+	Rock_Shape{0x00001818, 2}   // square
 };
 
-struct Rock {
+/*
+ * The fallen rocks, above a full floor. Only the rows a falling rock could still reach are kept, in a ring buffer:
+ * after every rock, the air open to the top is swept down row by row, spreading sideways through empty cells (rocks
+ * never move up), and the rows below the first one with no open air are dropped and read as solid from then on. The
+ * open air of each row, from the top down, is the chamber's surface: a rock only ever moves through open air, so two
+ * chambers with the same surface play out the same from then on.
+ *
+ * Open air can run all the way down a well the jets never steer a rock into, so the sweep stops after the surface
+ * depth. Below that every row is kept until one is found sealed off, and the surface only pins the chamber down from
+ * surface_floor() up.
+ */
+struct Chamber {
+
+	Chamber()
+		: rows_(INITIAL_CAPACITY, 0) { }
 
-	Rock(Rock_Shape blocks, Position position)
-			: blocks_{std::move(blocks)},
-			  position_{std::move(position)} {
-		width_ = std::max_element(blocks_.begin(), blocks_.end(), [](const auto &lhs, const auto &rhs) { return lhs.x < rhs.x; })->x + 1;
+	/*
+	 * Rows of rock above the floor.
+	 */
+	[[nodiscard]] std::size_t height() const noexcept {
+		return height_;
 	}
 
-	void move_left(const Chamber &chamber) noexcept {
-		if (can_move(chamber, -1, 0))
-			--position_.x;
+	/*
+	 * The open air of each row from the top of the rocks down, as of the last rock dropped.
+	 */
+	[[nodiscard]] std::span<const Row_Mask> surface() const noexcept {
+		return surface_;
 	}
 
-	void move_right(const Chamber &chamber) noexcept {
-		if (can_move(chamber, 1, 0))
-			++position_.x;
+	/*
+	 * The lowest row the surface pins down: the sealed row under it, or its bottom row if the open air runs deeper.
+	 */
+	[[nodiscard]] std::size_t surface_floor() const noexcept {
+		return surface_floor_;
 	}
 
-	bool try_move_down(const Chamber &chamber) noexcept {
-		if (can_move(chamber, 0, -1)) {
-			--position_.y;
-			return true;
-		}
-		return false;
+	/*
+	 * Doubles how deep the surface is swept from the next rock on.
+	 */
+	void deepen_surface() noexcept {
+		surface_depth_ *= 2;
 	}
 
-	void place(Chamber &chamber) noexcept {
-		for (const auto &block : blocks_) {
-			const auto row = static_cast<std::size_t>(position_.y + block.y);
-			if (row >= chamber.size())
-				chamber.resize(row + 1);
-			chamber[row][position_.x + block.x] = true;
+	/*
+	 * Drops a rock from its spawn point, pushed by the jets from the given index on, and leaves the index at the next
+	 * jet once the rock comes to rest. Returns the row its bottom came to rest on; the row below is the lowest it read.
+	 */
+	std::size_t drop(const Rock_Shape &shape, const std::vector<Direction> &jets, std::size_t &jet) {
+		auto stack = shape.stack;
+		auto row = height_ + 1 + SPAWN_GAP;
+		for (;;) {
+			const auto left = jets[jet] == Direction::LEFT;
+			if (++jet == jets.size())
+				jet = 0;
+			const auto pushed = left ? stack << 1 : stack >> 1;
+			const auto wall = left ? LEFT_WALL : RIGHT_WALL;
+			stack = ((stack & wall) | (pushed & window(row))) == 0 ? pushed : stack;
+			if ((stack & window(row - 1)) != 0)
+				break;
+			--row;
 		}
+		for (std::size_t i = 0; i < 4; ++i)
+			rows_[(row + i) & (rows_.size() - 1)] |= static_cast<Row_Mask>(stack >> (8 * i));
+		height_ = std::max(height_, row - 1 + shape.height);
+		sweep_surface();
+		// Room for the next rock to be tested anywhere above the kept rows
+		if (height_ + 1 + SPAWN_GAP + 4 - base_ > rows_.size())
+			grow();
+		AOC_GAUGE("simulate: peak rows kept", height_ + 1 - base_);
+		return row;
 	}
 
 private:
-	Rock_Shape blocks_;
-	Position position_;
-	int width_;
-
-	bool can_move(const Chamber &chamber, int x, int y) const noexcept {
-		for (const auto &block : blocks_) {
-			const auto row = position_.y + y + block.y;
-			const auto col = position_.x + x + block.x;
-			if (row < 0 || col < 0 || col >= CHAMBER_WIDTH || (row < static_cast<int>(chamber.size()) && chamber[row][col]))
-				return false;
+	static constexpr std::size_t SPAWN_GAP{3};
+	static constexpr std::size_t INITIAL_CAPACITY{64};
+	static constexpr std::size_t INITIAL_SURFACE_DEPTH{64};
+
+	std::vector<Row_Mask> rows_;
+	std::size_t base_{1};
+	std::size_t height_{0};
+	std::vector<Row_Mask> surface_;
+	std::size_t surface_depth_{INITIAL_SURFACE_DEPTH};
+	std::size_t surface_floor_{0};
+
+	/*
+	 * A row by its height above the floor; rows below the kept ones are solid.
+	 */
+	[[nodiscard]] Row_Mask row(std::size_t row) const noexcept {
+		return row < base_ ? FLOOR : rows_[row & (rows_.size() - 1)];
+	}
+
+	/*
+	 * The four rows from the given one up, packed like a rock stack.
+	 */
+	[[nodiscard]] Rock_Stack window(std::size_t row) const noexcept {
+		return static_cast<Rock_Stack>(this->row(row)) | static_cast<Rock_Stack>(this->row(row + 1)) << 8
+				| static_cast<Rock_Stack>(this->row(row + 2)) << 16 | static_cast<Rock_Stack>(this->row(row + 3)) << 24;
+	}
+
+	void sweep_surface() {
+		surface_.clear();
+		const auto lowest = std::max(base_, height_ >= surface_depth_ ? height_ + 1 - surface_depth_ : std::size_t{1});
+		Row_Mask open{FLOOR};
+		auto r = height_;
+		for (; r >= lowest; --r) {
+			const auto rock = row(r);
+			auto reached = static_cast<Row_Mask>(open & ~rock);
+			for (auto spread = reached;; reached = spread) {
+				spread = static_cast<Row_Mask>((reached | reached << 1 | reached >> 1) & ~rock & FLOOR);
+				if (spread == reached)
+					break;
+			}
+			if (reached == 0)
+				break;
+			surface_.push_back(reached);
+			open = reached;
+		}
+
+		// Row r is sealed off, and so is the row under the kept ones, unless the open air runs deeper than the sweep
+		// went, in which case every row is kept
+		if (r >= lowest) {
+			for (auto dropped = base_; dropped <= r; ++dropped)
+				rows_[dropped & (rows_.size() - 1)] = 0;
+			base_ = r + 1;
+		}
+		surface_floor_ = r >= lowest || lowest == base_ ? r : r + 1;
+	}
+
+	void grow() {
+		AOC_COUNT("simulate: chamber growths", 1);
+		std::vector<Row_Mask> rows(2 * rows_.size(), 0);
+		for (auto r = base_; r <= height_; ++r)
+			rows[r & (rows.size() - 1)] = row(r);
+		rows_ = std::move(rows);
+	}
+};
+
+/*
+ * Every state seen so far, keyed on a hash of the next jet, the next shape and the chamber's surface. Only the hash is
+ * kept of each surface, so a match is just a candidate for the caller to confirm.
+ */
+struct Cycle_Table {
+	struct Entry {
+		std::size_t rocks, height;
+		std::size_t jet, shape;
+	};
+
+	/*
+	 * The earlier entry whose state hashes the same, or nothing after recording this one.
+	 */
+	std::optional<Entry> find_or_insert(std::size_t jet, std::size_t shape, std::span<const Row_Mask> surface,
+			std::size_t rocks, std::size_t height) {
+		auto key = hash_combine(pack_key(static_cast<std::int32_t>(jet), static_cast<std::int32_t>(shape)), surface.size());
+		for (std::size_t i = 0; i < surface.size(); i += 8) {
+			std::uint64_t word{0};
+			for (auto j = i; j < std::min(i + 8, surface.size()); ++j)
+				word |= static_cast<std::uint64_t>(surface[j]) << (8 * (j - i));
+			key = hash_combine(key, word);
 		}
-		return true;
+		AOC_COUNT("simulate: states recorded", 1);
+		const Entry entry{rocks, height, jet, shape};
+		const auto [it, inserted] = entries_.insert(std::make_pair(key, entry));
+		if (!inserted) {
+			if (it->second.jet == jet && it->second.shape == shape)
+				return it->second;
+			AOC_COUNT("simulate: state hash collisions", 1);
+			it->second = entry;
+		}
+		return std::nullopt;
 	}
+
+private:
+	Flat_Hash_Map<std::uint64_t, Entry, Mixed_Key_Hash> entries_;
+};
+
+/*
+ * A cycle the table suggests, checked by playing one more period from the later state. It holds if the surface and
+ * jet come back exactly and no rock read a row below the surface's floor, as each period then plays out the same as
+ * the one before it.
+ */
+struct Cycle_Check {
+	std::size_t rocks, height, jet, period;
+	std::size_t floor, lowest_read;
+	std::vector<Row_Mask> surface;
 };
 
-static Circular_Queue<Direction> read_input(std::istream &in) {
+static std::vector<Direction> read_input(Input_Source &in) {
 	std::vector<Direction> directions;
-	for (char c; in >> c; ) {
+	for (auto c : read_line(in)) {
 		if (c == '<')
 			directions.push_back(Direction::LEFT);
 		else if (c == '>')
@@ -78,51 +232,70 @@ static Circular_Queue<Direction> read_input(std::istream &in) {
 		else
 			throw std::runtime_error{std::string{"Unexpected input character: "} + c};
 	}
-	return Circular_Queue<Direction>(std::move(directions));
+	if (directions.empty())
+		throw std::runtime_error{"No jets in input"};
+	return directions;
 }
 
-static std::size_t simulate(Circular_Queue<Direction> directions, std::size_t num_rocks) {
-	Circular_Queue<Rock_Shape> rock_shapes{ROCK_SHAPES};
+/*
+ * Drops rocks until a state repeats and the repeat is confirmed, skips every whole cycle that still fits, then drops
+ * the rest. A check that fails because a rock reached below the surface's floor deepens the surface and starts the
+ * table over.
+ */
+static std::size_t simulate(const std::vector<Direction> &jets, std::size_t num_rocks) {
+	AOC_TIMER("simulate");
 	Chamber chamber;
-	std::size_t height{0};
-	std::size_t prev_rock_position{static_cast<std::size_t>(-1)};
-	std::size_t prev_chamber_size{0};
-	std::size_t prev_count{0};
-	for (std::size_t count = 0; count < num_rocks; ++count) {
-		Rock rock{rock_shapes.take(), Position{2, static_cast<int>(chamber.size()) + 3}};
-		do {
-			if (directions.take() == Direction::LEFT)
-				rock.move_left(chamber);
-			else
-				rock.move_right(chamber);
-			if (directions.at_start()) {
-				if (rock_shapes.position() == prev_rock_position) {
-					const auto pattern_height = chamber.size() - prev_chamber_size;
-					const auto pattern_count = count - prev_count;
-					const auto remaining_rocks = num_rocks - count;
-					height += (remaining_rocks / pattern_count) * pattern_height;
-					num_rocks = count + remaining_rocks % pattern_count;
-				}
-				prev_rock_position = rock_shapes.position();
-				prev_chamber_size = chamber.size();
-				prev_count = count;
+	Cycle_Table cycles;
+	std::optional<Cycle_Check> check;
+	std::size_t jet{0};
+	std::size_t skipped_height{0};
+	bool skipped{false};
+	for (std::size_t rocks = 0; rocks < num_rocks;) {
+		const auto landed = chamber.drop(ROCK_SHAPES[rocks % ROCK_SHAPES.size()], jets, jet);
+		++rocks;
+		if (skipped)
+			continue;
+		if (check) {
+			check->lowest_read = std::min(check->lowest_read, landed - 1);
+			if (rocks < check->rocks + check->period)
+				continue;
+			if (check->lowest_read < check->floor) {
+				AOC_COUNT("simulate: surface deepenings", 1);
+				chamber.deepen_surface();
+				cycles = Cycle_Table{};
+			} else if (jet == check->jet && std::ranges::equal(chamber.surface(), check->surface)) {
+				const auto num_cycles = (num_rocks - rocks) / check->period;
+				skipped_height = num_cycles * (chamber.height() - check->height);
+				num_rocks -= num_cycles * check->period;
+				skipped = true;
+				continue;
 			}
-		} while (rock.try_move_down(chamber));
-		rock.place(chamber);
+			AOC_COUNT("simulate: cycles rejected", 1);
+			check.reset();
+		}
+		const auto surface = chamber.surface();
+		if (const auto seen = cycles.find_or_insert(jet, rocks % ROCK_SHAPES.size(), surface, rocks, chamber.height())) {
+			check = Cycle_Check{rocks, chamber.height(), jet, rocks - seen->rocks, chamber.surface_floor(),
+					std::numeric_limits<std::size_t>::max(), std::vector<Row_Mask>{surface.begin(), surface.end()}};
+		}
 	}
-	return height + chamber.size();
+	return skipped_height + chamber.height();
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	auto directions = read_input(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << simulate(std::move(directions), 2022) << std::endl;
-		break;
-	case 2:
-		std::cout << simulate(std::move(directions), 1000000000000) << std::endl;
-		break;
+struct Solution {
+	static std::vector<Direction> parse(Input_Source &input) {
+		return read_input(input);
+	}
+
+	static std::size_t part1(const std::vector<Direction> &jets) {
+		return simulate(jets, 2022);
+	}
+
+	static std::size_t part2(const std::vector<Direction> &jets) {
+		return simulate(jets, 1000000000000);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(17, Solution)
@@ -2,11 +2,13 @@
 #include <deque>
 #include <unordered_set>
 
-static std::vector<Position3D> read_input(std::istream &in) {
+namespace {
+
+static std::vector<Position3D> read_input(Input_Source &in) {
 	std::vector<Position3D> positions;
-	for (std::string line; std::getline(in, line); ) {
-		const auto tokens = read_tokens(line, ',');
-		positions.push_back(Position3D{std::stoi(tokens[0]) + 1, std::stoi(tokens[1]) + 1, std::stoi(tokens[2]) + 1});
+	while (has_input(in)) {
+		const auto tokens = read_tokens(read_line(in), ',');
+		positions.push_back(Position3D{parse_number(tokens[0]) + 1, parse_number(tokens[1]) + 1, parse_number(tokens[2]) + 1});
 	}
 	return positions;
 }
@@ -18,51 +20,91 @@ static std::tuple<int, int, int> max_coords(const std::vector<Position3D> &posit
 	return std::make_tuple(max_x, max_y, max_z);
 }
 
-static auto create_grid(const std::vector<Position3D> &positions) {
+/*
+ * Voxels are stored in a single Grid, one row per (x, y) column of z values.
+ */
+struct Voxel_Grid {
+
+	Voxel_Grid(int size_x, int size_y, int size_z)
+		: size_x_{size_x},
+		  size_y_{size_y},
+		  size_z_{size_z},
+		  cells_{static_cast<std::size_t>(size_x * size_y), static_cast<std::size_t>(size_z), 0} { }
+
+	[[nodiscard]] bool in_bounds(const Position3D &position) const noexcept {
+		return 0 <= position.x && position.x < size_x_
+			&& 0 <= position.y && position.y < size_y_
+			&& 0 <= position.z && position.z < size_z_;
+	}
+
+	[[nodiscard]] std::uint8_t &operator[](const Position3D &position) noexcept {
+		return cells_(position.x * size_y_ + position.y, position.z);
+	}
+
+	[[nodiscard]] std::uint8_t operator[](const Position3D &position) const noexcept {
+		return cells_(position.x * size_y_ + position.y, position.z);
+	}
+
+private:
+	int size_x_, size_y_, size_z_;
+	Grid<std::uint8_t> cells_;
+};
+
+static Voxel_Grid create_grid(const std::vector<Position3D> &positions) {
 	const auto [max_x, max_y, max_z] = max_coords(positions);
-	std::vector<std::vector<std::vector<std::uint8_t>>> grid(max_x + 2,
-															 std::vector<std::vector<std::uint8_t>>(max_y + 2,
-																 									std::vector<std::uint8_t>(max_z + 2, 0)));
+	Voxel_Grid grid{max_x + 2, max_y + 2, max_z + 2};
 	for (const auto &position : positions)
-		grid[position.x][position.y][position.z] = 1;
+		grid[position] = 1;
 	return grid;
 }
 
-static int surface_area(const std::vector<Position3D> &positions) {
+/*
+ * The cube positions together with their voxel grid, which is built once and shared by both parts.
+ */
+struct Droplet {
+	std::vector<Position3D> positions;
+	Voxel_Grid grid;
+};
+
+static Droplet read_droplet(Input_Source &in) {
+	auto positions = read_input(in);
 	auto grid = create_grid(positions);
+	return Droplet{std::move(positions), std::move(grid)};
+}
+
+static int surface_area(const Droplet &droplet) {
+	const auto &grid = droplet.grid;
 	int count{0};
-	for (const auto &position : positions) {
-		if (grid[position.x - 1][position.y][position.z] == 0)
+	for (const auto &position : droplet.positions) {
+		if (grid[Position3D{position.x - 1, position.y, position.z}] == 0)
 			++count;
-		if (grid[position.x + 1][position.y][position.z] == 0)
+		if (grid[Position3D{position.x + 1, position.y, position.z}] == 0)
 			++count;
-		if (grid[position.x][position.y - 1][position.z] == 0)
+		if (grid[Position3D{position.x, position.y - 1, position.z}] == 0)
 			++count;
-		if (grid[position.x][position.y + 1][position.z] == 0)
+		if (grid[Position3D{position.x, position.y + 1, position.z}] == 0)
 			++count;
-		if (grid[position.x][position.y][position.z - 1] == 0)
+		if (grid[Position3D{position.x, position.y, position.z - 1}] == 0)
 			++count;
-		if (grid[position.x][position.y][position.z + 1] == 0)
+		if (grid[Position3D{position.x, position.y, position.z + 1}] == 0)
 			++count;
 	}
 	return count;
 }
 
-static int exterior_surface_area(const std::vector<Position3D> &positions) {
+static int exterior_surface_area(const Droplet &droplet) {
 	static constexpr std::uint8_t VISITED{255};
 
-	auto grid = create_grid(positions);
-	grid[0][0][0] = VISITED;
+	auto grid = droplet.grid;
+	grid[Position3D{0, 0, 0}] = VISITED;
 	std::deque<Position3D> to_visit{Position3D{0, 0, 0}};
 	int count{0};
 	const auto check_position = [&grid, &to_visit, &count](const Position3D &position) {
-		if (0 <= position.x && position.x < static_cast<int>(grid.size())
-				&& 0 <= position.y && position.y < static_cast<int>(grid[0].size())
-				&& 0 <= position.z && position.z < static_cast<int>(grid[0][0].size())) {
-			if (grid[position.x][position.y][position.z] == 0) {
+		if (grid.in_bounds(position)) {
+			if (grid[position] == 0) {
 				to_visit.push_back(position);
-				grid[position.x][position.y][position.z] = VISITED;
-			} else if (grid[position.x][position.y][position.z] == 1) {
+				grid[position] = VISITED;
+			} else if (grid[position] == 1) {
 				++count;
 			}
 		}
@@ -82,16 +124,20 @@ static int exterior_surface_area(const std::vector<Position3D> &positions) {
 	return count;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	auto positions = read_input(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << surface_area(positions) << std::endl;
-		break;
-	case 2:
-		std::cout << exterior_surface_area(positions) << std::endl;
-		break;
+struct Solution {
+	static Droplet parse(Input_Source &input) {
+		return read_droplet(input);
+	}
+
+	static int part1(const Droplet &droplet) {
+		return surface_area(droplet);
+	}
+
+	static int part2(const Droplet &droplet) {
+		return exterior_surface_area(droplet);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(18, Solution)
@@ -1,213 +1,412 @@
 #include "common.h"
+#include <array>
+#include <future>
+#include <iterator>
 #include <numeric>
-
-struct Counts {
-	int ore{0}, clay{0}, obsidian{0}, geode{0};
-
-	Counts &operator+=(const Counts &other) noexcept {
-		ore += other.ore;
-		clay += other.clay;
-		obsidian += other.obsidian;
-		geode += other.geode;
-		return *this;
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+/*
+ * A factory with N resources has one robot per resource, each collecting one unit of its resource a minute. Robots
+ * appear in the order their recipes are listed, and the last one collects the resource being maximised (the geode).
+ */
+template<std::size_t N>
+using Counts = std::array<int, N>;
+
+/*
+ * Arithmetic on resource counts, specialised on N through its index sequence: every operation expands at compile time
+ * into N independent lane operations with no loop or early exit, which the optimiser can turn into vector code.
+ */
+template<std::size_t N, typename Indices = std::make_index_sequence<N>>
+struct Kernel;
+
+template<std::size_t N, std::size_t... I>
+struct Kernel<N, std::index_sequence<I...>> {
+	[[nodiscard]] static bool covers(const Counts<N> &resources, const Counts<N> &cost) noexcept {
+		return ((resources[I] >= cost[I]) & ...);
 	}
 
-	Counts &operator-=(const Counts &other) noexcept {
-		return *this += Counts{-other.ore, -other.clay, -other.obsidian, -other.geode};
+	/*
+	 * Resources after collecting for the given minutes and paying the cost.
+	 */
+	[[nodiscard]] static Counts<N> collect_and_pay(const Counts<N> &resources, const Counts<N> &robots, int minutes, const Counts<N> &cost) noexcept {
+		return Counts<N>{(resources[I] + robots[I] * minutes - cost[I])...};
 	}
 
-	[[nodiscard]] Counts operator+(const Counts &other) const noexcept {
-		return Counts{*this} += other;
+	/*
+	 * Minutes until a robot with the given cost is built: waiting for the resources it needs, then one to build it. Zero
+	 * if the robots collecting those resources do not exist yet.
+	 */
+	[[nodiscard]] static int minutes_to_build(const Counts<N> &cost, const Counts<N> &resources, const Counts<N> &robots) noexcept {
+		if (!((cost[I] <= resources[I] || robots[I] > 0) & ...))
+			return 0;
+		return std::max({0, (cost[I] <= resources[I] ? 0 : (cost[I] - resources[I] + robots[I] - 1) / robots[I])...}) + 1;
 	}
 
-	[[nodiscard]] Counts operator-(const Counts &other) const noexcept {
-		return Counts{*this} -= other;
+	[[nodiscard]] static Counts<N> max_of(const Counts<N> &lhs, const Counts<N> &rhs) noexcept {
+		return Counts<N>{std::max(lhs[I], rhs[I])...};
 	}
 };
 
-struct Blueprint : Line_Reader<Blueprint> {
+/*
+ * One line of the input as read: the robot (and so resource) names in order and each robot's costs by resource.
+ */
+struct Blueprint_Info : Line_Reader<Blueprint_Info> {
 
-	void read_line(const std::string &line) final {
-		std::size_t pos{0};
-
-		id_ = read_id(line, pos);
-		ore_robot_ = Costs{read_single_cost(line, pos), 0, 0};
-		clay_robot_ = Costs{read_single_cost(line, pos), 0, 0};
-		
-		const auto [obsidian_robot_ore, obsidian_robot_clay] = read_two_costs(line, pos);
-		obsidian_robot_ = Costs{obsidian_robot_ore, obsidian_robot_clay, 0};
+	void read_line(std::string_view line) {
+		const auto id_start = line.find(' ') + 1;
+		const auto id_end = line.find(':', id_start);
+		id_ = parse_number(line.substr(id_start, id_end - id_start));
+
+		std::vector<std::vector<std::pair<int, std::string_view>>> recipes;
+		for (auto pos = line.find("Each ", id_end); pos != std::string_view::npos; pos = line.find("Each ", pos)) {
+			const auto name_start = pos + std::string_view{"Each "}.size();
+			const auto name_end = line.find(' ', name_start);
+			names_.emplace_back(line.substr(name_start, name_end - name_start));
+
+			auto &recipe = recipes.emplace_back();
+			const auto costs_start = line.find("costs ", name_end) + std::string_view{"costs "}.size();
+			const auto costs_end = line.find('.', costs_start);
+			for (auto cost_start = costs_start; cost_start < costs_end;) {
+				const auto amount_end = line.find(' ', cost_start);
+				const auto resource_end = std::min(line.find(' ', amount_end + 1), costs_end);
+				recipe.emplace_back(parse_number(line.substr(cost_start, amount_end - cost_start)),
+						line.substr(amount_end + 1, resource_end - amount_end - 1));
+				cost_start = resource_end + std::string_view{" and "}.size();
+			}
+			pos = costs_end;
+		}
 
-		const auto [geode_robot_ore, geode_robot_obsidian] = read_two_costs(line, pos);
-		geode_robot_ = Costs{geode_robot_ore, 0, geode_robot_obsidian};
+		costs_.assign(names_.size(), std::vector<int>(names_.size(), 0));
+		for (std::size_t robot = 0; robot < recipes.size(); ++robot) {
+			for (const auto &[amount, resource] : recipes[robot])
+				costs_[robot][resource_index(resource)] += amount;
+		}
 	}
 
 	[[nodiscard]] int id() const noexcept {
 		return id_;
 	}
 
-	[[nodiscard]] int highest_ore_cost() const noexcept {
-		return std::max(ore_robot_.ore, std::max(clay_robot_.ore, std::max(obsidian_robot_.ore, geode_robot_.ore)));
+	[[nodiscard]] const std::vector<std::string> &names() const noexcept {
+		return names_;
 	}
 
-	[[nodiscard]] int highest_clay_cost() const noexcept {
-		return std::max(ore_robot_.clay, std::max(clay_robot_.clay, std::max(obsidian_robot_.clay, geode_robot_.clay)));
+	[[nodiscard]] const std::vector<std::vector<int>> &costs() const noexcept {
+		return costs_;
 	}
 
-	[[nodiscard]] int highest_obsidian_cost() const noexcept {
-		return std::max(ore_robot_.obsidian, std::max(clay_robot_.obsidian, std::max(obsidian_robot_.obsidian, geode_robot_.obsidian)));
-	}
-
-	[[nodiscard]] bool can_build_any_robot(const Counts &resources, int time) const noexcept {
-		if (time >= 2 && !can_build_geode_robot(resources))
-			return false;
-		if (time >= 4 && (!can_build_ore_robot(resources) || !can_build_obsidian_robot(resources)))
-			return false;
-		if (time >= 6 && !can_build_clay_robot(resources))
-			return false;
-		return true;
+private:
+	int id_;
+	std::vector<std::string> names_;
+	std::vector<std::vector<int>> costs_;
+
+	[[nodiscard]] std::size_t resource_index(std::string_view resource) const {
+		const auto it = std::find(names_.begin(), names_.end(), resource);
+		if (it == names_.end())
+			throw std::invalid_argument{"Blueprint " + std::to_string(id_) + ": unknown resource " + std::string{resource}};
+		return it - names_.begin();
 	}
+};
 
-	[[nodiscard]] bool can_build_ore_robot(const Counts &resources) const noexcept {
-		auto new_resources = build_ore_robot(resources);
-		return new_resources.ore >= 0 && new_resources.clay >= 0 && new_resources.obsidian >= 0;
+template<std::size_t N>
+struct Blueprint {
+	explicit Blueprint(const Blueprint_Info &info)
+		: id{info.id()} {
+		for (std::size_t robot = 0; robot < N; ++robot) {
+			std::copy(info.costs()[robot].begin(), info.costs()[robot].end(), costs[robot].begin());
+			max_spend = Kernel<N>::max_of(max_spend, costs[robot]);
+		}
 	}
 
-	[[nodiscard]] bool can_build_clay_robot(const Counts &resources) const noexcept {
-		auto new_resources = build_clay_robot(resources);
-		return new_resources.ore >= 0 && new_resources.clay >= 0 && new_resources.obsidian >= 0;
-	}
+	int id;
+	std::array<Counts<N>, N> costs{};
+	// The most of each resource any one robot costs: as only one robot is built a minute, more robots of a kind than
+	// that can never be put to use
+	Counts<N> max_spend{};
+};
 
-	[[nodiscard]] bool can_build_obsidian_robot(const Counts &resources) const noexcept {
-		auto new_resources = build_obsidian_robot(resources);
-		return new_resources.ore >= 0 && new_resources.clay >= 0 && new_resources.obsidian >= 0;
-	}
+static constexpr int MAX_TIME{63};
+static constexpr int MAX_COST{63};
+static constexpr std::size_t CACHE_BYTES{std::size_t{4} << 20};
 
-	[[nodiscard]] bool can_build_geode_robot(const Counts &resources) const noexcept {
-		auto new_resources = build_geode_robot(resources);
-		return new_resources.ore >= 0 && new_resources.clay >= 0 && new_resources.obsidian >= 0;
-	}
+/*
+ * A search state packed into two words: the minutes elapsed and the robot counts (bar geode robots) in 6 bits each,
+ * and the resources (bar geodes) in 12 bits each.
+ */
+struct Search_Key {
+	std::uint64_t robots, resources;
 
-	[[nodiscard]] Counts build_ore_robot(Counts resources) const noexcept {
-		resources.ore -= ore_robot_.ore;
-		resources.clay -= ore_robot_.clay;
-		resources.obsidian -= ore_robot_.obsidian;
-		return resources;
+	[[nodiscard]] bool operator==(const Search_Key &other) const noexcept {
+		return robots == other.robots && resources == other.resources;
 	}
+};
 
-	[[nodiscard]] Counts build_clay_robot(Counts resources) const noexcept {
-		resources.ore -= clay_robot_.ore;
-		resources.clay -= clay_robot_.clay;
-		resources.obsidian -= clay_robot_.obsidian;
-		return resources;
+struct Search_Key_Hasher {
+	[[nodiscard]] std::size_t operator()(const Search_Key &key) const noexcept {
+		return hash_combine(mix_hash(key.robots), key.resources);
 	}
+};
 
-	[[nodiscard]] Counts build_obsidian_robot(Counts resources) const noexcept {
-		resources.ore -= obsidian_robot_.ore;
-		resources.clay -= obsidian_robot_.clay;
-		resources.obsidian -= obsidian_robot_.obsidian;
-		return resources;
-	}
+/*
+ * Geodes a state has banked by the time it is reached and by the longest horizon. Banked geodes grow linearly with the
+ * horizon, so a state that is ahead at both ends is ahead at every horizon in between.
+ */
+struct Geode_Tally {
+	int now, at_max;
+};
 
-	[[nodiscard]] Counts build_geode_robot(Counts resources) const noexcept {
-		resources.ore -= geode_robot_.ore;
-		resources.clay -= geode_robot_.clay;
-		resources.obsidian -= geode_robot_.obsidian;
-		return resources;
+using Search_Cache = Capped_Cache<Geode_Tally, Search_Key, Search_Key_Hasher>;
+
+/*
+ * Depth-first branch-and-bound that jumps from one robot build straight to the next: for each robot worth building,
+ * the factory waits until it can afford it and then builds it. Time runs forwards, so one search answers every horizon
+ * up to the longest: a geode robot finished after e minutes yields T - e geodes by minute T, and each state records
+ * what the robots built so far yield at every horizon from its own time on. Geodes and geode robots are tracked as that
+ * count and the sum of their build times rather than as part of the state.
+ *
+ * A state is cut if at no horizon could it beat the best found so far, even with every resource but the geode robot's
+ * last ingredient free, or if the cache has already seen it reached with at least as many geodes at every horizon.
+ */
+template<std::size_t N>
+struct Geode_Search {
+	static constexpr std::size_t GEODE{N - 1};
+	static constexpr std::size_t LAST_INGREDIENT{N - 2};
+
+	Geode_Search(const Blueprint<N> &blueprint, Search_Cache &cache, int max_time)
+		: blueprint_{blueprint},
+		  cache_{cache},
+		  max_time_{max_time},
+		  best_(std::max(max_time, 0) + 1, 0) { }
+
+	/*
+	 * The most geodes after each number of minutes from 0 to the longest horizon.
+	 */
+	std::vector<int> run() {
+		const auto &max_spend = blueprint_.max_spend;
+		if (max_time_ > MAX_TIME || *std::max_element(max_spend.begin(), max_spend.end()) > MAX_COST)
+			throw std::invalid_argument{"Unsupported blueprint " + std::to_string(blueprint_.id) + " for " + std::to_string(max_time_) + " minutes"};
+		Counts<N> robots{};
+		robots[0] = 1;
+		if (max_time_ > 0)
+			search(Counts<N>{}, robots, 0, 0, 0);
+		return best_;
 	}
 
 private:
-	struct Costs {
-		int ore, clay, obsidian;
-	};
+	const Blueprint<N> &blueprint_;
+	Search_Cache &cache_;
+	int max_time_;
+	std::vector<int> best_;
+
+	void search(const Counts<N> &resources, const Counts<N> &robots, int elapsed, int geode_robots, int build_times) {
+		AOC_COUNT("max_geode: nodes expanded", 1);
+		if (!record_and_bound(resources, robots, elapsed, geode_robots, build_times)) {
+			AOC_COUNT("max_geode: bound prunes", 1);
+			return;
+		}
+		const auto key = pack_state(resources, robots, elapsed);
+		const Geode_Tally tally{geode_robots * elapsed - build_times, geode_robots * max_time_ - build_times};
+		if (const auto seen = cache_.find(key); seen != nullptr && seen->now >= tally.now && seen->at_max >= tally.at_max) {
+			AOC_COUNT("max_geode: cache hits", 1);
+			return;
+		}
+		AOC_COUNT("max_geode: cache misses", 1);
+		cache_.insert(key, tally);
 
-	[[nodiscard]] static int read_id(const std::string &line, std::size_t &pos) {
-		const auto id_start = line.find(' ') + 1;
-		const auto id_end = line.find(':', id_start);
-		pos = id_end;
-		return std::stoi(line.substr(id_start, id_end));
+		try_build(GEODE, resources, robots, elapsed, geode_robots, build_times);
+		for (auto robot = GEODE; robot-- > 0;) {
+			if (robots[robot] < blueprint_.max_spend[robot])
+				try_build(robot, resources, robots, elapsed, geode_robots, build_times);
+		}
 	}
 
-	[[nodiscard]] static int read_single_cost(const std::string &line, std::size_t &pos) {
-		const auto cost_start = line.find("costs ", pos) + std::string{"costs "}.size();
-		const auto cost_end = line.find(' ', cost_start);
-		pos = cost_end;
-		return std::stoi(line.substr(cost_start, cost_end));
+	void try_build(std::size_t robot, const Counts<N> &resources, const Counts<N> &robots, int elapsed, int geode_robots, int build_times) {
+		const auto &cost = blueprint_.costs[robot];
+		const auto minutes = Kernel<N>::minutes_to_build(cost, resources, robots);
+		// Any robot but a geode robot needs a few minutes more to lead to an extra geode
+		if (minutes == 0 || elapsed + minutes + (robot == GEODE ? 1 : 3) > max_time_)
+			return;
+		const auto next_resources = Kernel<N>::collect_and_pay(resources, robots, minutes, cost);
+		const auto built = elapsed + minutes;
+		if (robot == GEODE) {
+			search(next_resources, robots, built, geode_robots + 1, build_times + built);
+		} else {
+			auto next_robots = robots;
+			++next_robots[robot];
+			search(next_resources, next_robots, built, geode_robots, build_times);
+		}
 	}
 
-	[[nodiscard]] static std::pair<int, int> read_two_costs(const std::string &line, std::size_t &pos) {
-		const auto cost1_start = line.find("costs ", pos) + std::string{"costs "}.size();
-		const auto cost1_end = line.find(' ', cost1_start);
-		const auto cost2_start = line.find("and ", cost1_end) + std::string{"and "}.size();
-		const auto cost2_end = line.find(' ', cost2_start);
-		pos = cost2_end;
-		return std::make_pair(std::stoi(line.substr(cost1_start, cost1_end)), std::stoi(line.substr(cost2_start, cost2_end)));
+	/*
+	 * Records the geodes banked at every horizon from now on, and returns whether at any of them the state could still
+	 * beat the best: that is, if only the geode robot's last ingredient had to be paid for, with a robot for it built
+	 * every minute and a geode robot too whenever there is enough of it.
+	 */
+	bool record_and_bound(const Counts<N> &resources, const Counts<N> &robots, int elapsed, int geode_robots, int build_times) {
+		const auto geode_cost = blueprint_.costs[GEODE][LAST_INGREDIENT];
+		auto ingredient = resources[LAST_INGREDIENT], ingredient_robots = robots[LAST_INGREDIENT];
+		int extra_robots{0}, extra_build_times{0};
+		bool promising{false};
+		for (auto time = elapsed; time <= max_time_; ++time) {
+			if (time > elapsed) {
+				if (ingredient >= geode_cost) {
+					ingredient -= geode_cost;
+					++extra_robots;
+					extra_build_times += time;
+				}
+				ingredient += ingredient_robots++;
+			}
+			const auto banked = geode_robots * time - build_times;
+			best_[time] = std::max(best_[time], banked);
+			promising |= banked + extra_robots * time - extra_build_times > best_[time];
+		}
+		return promising;
 	}
 
-	int id_;
-	Costs ore_robot_, clay_robot_, obsidian_robot_, geode_robot_;
+	/*
+	 * Resources beyond what could ever be spent before the longest horizon are capped first, so states that only
+	 * differ in unusable surplus share a key.
+	 */
+	[[nodiscard]] Search_Key pack_state(const Counts<N> &resources, const Counts<N> &robots, int elapsed) const noexcept {
+		const auto time = max_time_ - elapsed;
+		Search_Key key{static_cast<std::uint64_t>(elapsed), 0};
+		for (std::size_t resource = 0; resource < GEODE; ++resource) {
+			const auto spend = blueprint_.max_spend[resource];
+			const auto usable = std::min(resources[resource], spend * time - robots[resource] * (time - 1));
+			key.robots |= static_cast<std::uint64_t>(robots[resource]) << (6 * (resource + 1));
+			key.resources |= static_cast<std::uint64_t>(usable) << (12 * resource);
+		}
+		return key;
+	}
 };
 
-static std::string hash_key(const Counts &resources, const Counts &robots, int time) {
-	return std::to_string(time)
-			+ "," + std::to_string(resources.ore)
-			+ "," + std::to_string(resources.clay)
-			+ "," + std::to_string(resources.obsidian)
-			+ "," + std::to_string(resources.geode)
-			+ "," + std::to_string(robots.ore)
-			+ "," + std::to_string(robots.clay)
-			+ "," + std::to_string(robots.obsidian)
-			+ "," + std::to_string(robots.geode);
+/*
+ * The most geodes the blueprint yields after each number of minutes up to max_time, from a single search. Each thread
+ * keeps one search cache and clears it between blueprints rather than allocating a new one.
+ */
+template<std::size_t N>
+static std::vector<int> max_geode_by_horizon(const Blueprint<N> &blueprint, int max_time) {
+	AOC_TIMER("max_geode");
+	thread_local Search_Cache cache{CACHE_BYTES};
+	cache.clear();
+	return Geode_Search<N>{blueprint, cache, max_time}.run();
 }
 
-static int max_geode(const Blueprint &blueprint, const Counts &resources, const Counts &robots, int time, std::unordered_map<std::string, int> &cache) {
-	if (time == 1)
-		return resources.geode + robots.geode;
-
-	const auto key = hash_key(resources, robots, time);
-	auto it = cache.find(key);
-	if (it == cache.end()) {
-		const auto new_resources = resources + robots;
-		int max_val{-1};
-		if (blueprint.can_build_geode_robot(resources))
-			max_val = std::max(max_val, max_geode(blueprint, blueprint.build_geode_robot(new_resources), robots + Counts{0, 0, 0, 1}, time - 1, cache));
-		if (time >= 4) {
-			if (robots.obsidian < blueprint.highest_obsidian_cost() && blueprint.can_build_obsidian_robot(resources))
-				max_val = std::max(max_val, max_geode(blueprint, blueprint.build_obsidian_robot(new_resources), robots + Counts{0, 0, 1, 0}, time - 1, cache));
-			if (robots.ore < blueprint.highest_ore_cost() && blueprint.can_build_ore_robot(resources))
-				max_val = std::max(max_val, max_geode(blueprint, blueprint.build_ore_robot(new_resources), robots + Counts{1, 0, 0, 0}, time - 1, cache));
-		}
-		if (time >= 6 && robots.ore < blueprint.highest_clay_cost() && blueprint.can_build_clay_robot(resources))
-			max_val = std::max(max_val, max_geode(blueprint, blueprint.build_clay_robot(new_resources), robots + Counts{0, 1, 0, 0}, time - 1, cache));
-		if (max_val == -1 || !blueprint.can_build_any_robot(resources, time))
-			max_val = std::max(max_val, max_geode(blueprint, new_resources, robots, time - 1, cache));
-		it = cache.emplace(key, max_val).first;
+/*
+ * Rough relative cost of searching a blueprint: more first-resource robots worth building and a cheaper second robot
+ * both widen the search.
+ */
+template<std::size_t N>
+[[nodiscard]] static int estimated_effort(const Blueprint<N> &blueprint) noexcept {
+	return blueprint.max_spend[0] * 16 / std::max(blueprint.costs[1][0], 1);
+}
+
+/*
+ * Searches the blueprints concurrently on one thread pool, each to its own horizon in max_times, the longest horizons
+ * and then the most expensive-looking blueprints first so the longest searches are not left until the end. Returns
+ * the most geodes for every horizon up to its max_time for each blueprint.
+ */
+template<std::size_t N>
+static std::vector<std::vector<int>> max_geodes_by_horizon(std::span<const Blueprint_Info> infos, std::span<const int> max_times) {
+	const std::vector<Blueprint<N>> blueprints(infos.begin(), infos.end());
+	std::vector<std::size_t> order(blueprints.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&blueprints, max_times](auto lhs, auto rhs) {
+		if (max_times[lhs] != max_times[rhs])
+			return max_times[lhs] > max_times[rhs];
+		return estimated_effort(blueprints[lhs]) > estimated_effort(blueprints[rhs]);
+	});
+
+	std::vector<std::vector<int>> geodes(blueprints.size());
+	Thread_Pool pool{std::min(default_thread_count(), std::max<std::size_t>(blueprints.size(), 1))};
+	std::vector<std::future<void>> searches;
+	for (auto index : order) {
+		searches.push_back(pool.submit([&blueprints, max_times, index, &geodes] {
+			geodes[index] = max_geode_by_horizon(blueprints[index], max_times[index]);
+		}));
 	}
-	return it->second;
+	for (auto &search : searches)
+		search.get();
+	return geodes;
 }
 
-static int max_geode(const Blueprint &blueprint, int time) {
-	std::unordered_map<std::string, int> cache;
-	return max_geode(blueprint, Counts{}, Counts{1, 0, 0, 0}, time, cache);
+/*
+ * Picks the search instantiation for the number of resources in the blueprints.
+ */
+static std::vector<std::vector<int>> max_geodes_by_horizon(std::span<const Blueprint_Info> infos, std::span<const int> max_times) {
+	if (infos.empty())
+		return {};
+	const auto &names = infos.front().names();
+	for (const auto &info : infos) {
+		if (info.names() != names)
+			throw std::invalid_argument{"Blueprint " + std::to_string(info.id()) + " has different resources"};
+	}
+	switch (names.size()) {
+	case 2: return max_geodes_by_horizon<2>(infos, max_times);
+	case 3: return max_geodes_by_horizon<3>(infos, max_times);
+	case 4: return max_geodes_by_horizon<4>(infos, max_times);
+	case 5: return max_geodes_by_horizon<5>(infos, max_times);
+	case 6: return max_geodes_by_horizon<6>(infos, max_times);
+	default: throw std::invalid_argument{"Unsupported number of resources: " + std::to_string(names.size())};
+	}
 }
 
-static int quality_sum(const std::vector<Blueprint> &blueprints) {
-	return std::accumulate(blueprints.begin(), blueprints.end(), 0, [](auto sum, const auto &blueprint) {
-		return sum + blueprint.id() * max_geode(blueprint, 24);
-	});
+static constexpr int QUALITY_TIME{24};
+static constexpr int TOP_THREE_TIME{32};
+
+/*
+ * The horizon to search each blueprint to: TOP_THREE_TIME for the first num_top_three, QUALITY_TIME for the rest of
+ * the first num_blueprints.
+ */
+static std::vector<int> search_times(std::size_t num_blueprints, std::size_t num_top_three) {
+	std::vector<int> times(num_blueprints, QUALITY_TIME);
+	std::fill_n(times.begin(), std::min(num_top_three, num_blueprints), TOP_THREE_TIME);
+	return times;
+}
+
+static int quality_sum(const std::vector<Blueprint_Info> &blueprints, const std::vector<std::vector<int>> &geodes) {
+	int sum{0};
+	for (std::size_t i = 0; i < blueprints.size(); ++i)
+		sum += blueprints[i].id() * geodes[i][QUALITY_TIME];
+	return sum;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	std::vector<Blueprint> blueprints;
-	while (has_input(std::cin))
-		blueprints.push_back(Blueprint::create_from_stream(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << quality_sum(blueprints) << std::endl;
-		break;
-	case 2:
-		std::cout << (max_geode(blueprints[0], 32) * max_geode(blueprints[1], 32)  * max_geode(blueprints[2], 32)) << std::endl;
-		break;
-	}
-	return 0;
+static int top_three_product(const std::vector<std::vector<int>> &geodes) {
+	int product{1};
+	for (std::size_t i = 0; i < std::min<std::size_t>(geodes.size(), 3); ++i)
+		product *= geodes[i][TOP_THREE_TIME];
+	return product;
 }
+
+struct Solution {
+	static std::vector<Blueprint_Info> parse(Input_Source &input) {
+		return read_records<Blueprint_Info>(input);
+	}
+
+	static int part1(const std::vector<Blueprint_Info> &blueprints) {
+		return quality_sum(blueprints, max_geodes_by_horizon(blueprints, search_times(blueprints.size(), 0)));
+	}
+
+	static int part2(const std::vector<Blueprint_Info> &blueprints) {
+		const auto top_three = std::span{blueprints}.first(std::min<std::size_t>(blueprints.size(), 3));
+		return top_three_product(max_geodes_by_horizon(top_three, search_times(top_three.size(), 3)));
+	}
+
+	/*
+	 * One search over every blueprint on one pool: the first three to 32 minutes, which also answers part 1 for them,
+	 * and the rest to 24.
+	 */
+	static std::pair<int, int> both(const std::vector<Blueprint_Info> &blueprints) {
+		const auto geodes = max_geodes_by_horizon(blueprints, search_times(blueprints.size(), 3));
+		return std::make_pair(quality_sum(blueprints, geodes), top_three_product(geodes));
+	}
+};
+
+}
+
+AOC_SOLUTION(19, Solution)
@@ -2,10 +2,12 @@
 #include <cmath>
 #include <list>
 
-[[nodiscard]] static std::vector<int> read_input(std::istream &in) {
+namespace {
+
+[[nodiscard]] static std::vector<int> read_input(Input_Source &in) {
 	std::vector<int> numbers;
-	for (int num; in >> num; )
-		numbers.push_back(num);
+	while (has_input(in))
+		numbers.push_back(parse_number(read_line(in)));
 	return numbers;
 }
 
@@ -47,16 +49,20 @@
 	return sum;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto numbers = read_input(std::cin);	
-	switch (part) {
-	case 1:
-		std::cout << grove_sum(numbers, 1, 1) << std::endl;
-		break;
-	case 2:
-		std::cout << grove_sum(numbers, 811589153, 10) << std::endl;
-		break;
+struct Solution {
+	static std::vector<int> parse(Input_Source &input) {
+		return read_input(input);
+	}
+
+	static long part1(const std::vector<int> &numbers) {
+		return grove_sum(numbers, 1, 1);
 	}
-	return 0;
+
+	static long part2(const std::vector<int> &numbers) {
+		return grove_sum(numbers, 811589153, 10);
+	}
+};
+
 }
+
+AOC_SOLUTION(20, Solution)
@@ -1,26 +1,26 @@
 #include "common.h"
-#include <memory>
 #include <optional>
 #include <unordered_map>
 
+namespace {
+
 struct Node;
 
-using Node_Tree = std::unordered_map<std::string, std::unique_ptr<Node>>;
+using Node_Tree = std::unordered_map<std::string_view, Node *>;
 
 struct Node : Token_Reader<Node> {
 	enum class Operation { PLUS, MINUS, MULT, DIV };
 
-	void read_token(const std::string &token) final {
-		switch (token_num()) {
+	void read_token(std::size_t token_num, std::string_view token) {
+		switch (token_num) {
 		case 0:
 			name_ = token.substr(0, token.size() - 1);
 			break;
 		case 1:
-			try {
-				val_ = std::stoi(token);
-			} catch (const std::invalid_argument &) {
+			if (long val; std::from_chars(token.data(), token.data() + token.size(), val).ec == std::errc{})
+				val_ = val;
+			else
 				left_name_ = token;
-			}
 			break;
 		case 2:
 			op_ = read_op(token);
@@ -31,7 +31,7 @@ struct Node : Token_Reader<Node> {
 		}
 	}
 
-	[[nodiscard]] const std::string &name() const noexcept {
+	[[nodiscard]] std::string_view name() const noexcept {
 		return name_;
 	}
 
@@ -42,7 +42,7 @@ struct Node : Token_Reader<Node> {
 		return *val_;
 	};
 	
-	[[nodiscard]] long make_equal(const std::string &name) const {
+	[[nodiscard]] long make_equal(std::string_view name) const {
 		if (!left_ || !right_)
 			throw std::logic_error{"Can only call make_equal() on non-leaf node"};
 		return left_->contains(name) ? left_->make_value(name, right_->value()) : right_->make_value(name, left_->value());
@@ -50,25 +50,25 @@ struct Node : Token_Reader<Node> {
 
 	void link_children(const Node_Tree &nodes) {
 		if (!left_name_.empty()) {
-			left_ = nodes.at(left_name_).get();
-			right_ = nodes.at(right_name_).get();
+			left_ = nodes.at(left_name_);
+			right_ = nodes.at(right_name_);
 		}
 	}
 
 private:
 
-	[[nodiscard]] static Operation read_op(const std::string &token) {
+	[[nodiscard]] static Operation read_op(std::string_view token) {
 		switch (token.front()) {
 		case '+': return Operation::PLUS;
 		case '-': return Operation::MINUS;
 		case '*': return Operation::MULT;
 		case '/': return Operation::DIV;
 		default:
-			throw std::invalid_argument{token};
+			throw std::invalid_argument{std::string{token}};
 		}
 	}
 	
-	std::string name_, left_name_, right_name_;
+	std::string_view name_, left_name_, right_name_;
 	mutable std::optional<long> val_;
 	Node *left_{nullptr}, *right_{nullptr};
 	Operation op_;
@@ -100,39 +100,62 @@ private:
 		}
 	}
 
-	[[nodiscard]] long make_value(const std::string &name, long value) const noexcept {
+	[[nodiscard]] long make_value(std::string_view name, long value) const noexcept {
 		return name_ == name ? value
 			 : left_->contains(name) ? left_->make_value(name, reverse_rhs_op(value, right_->value()))
 			 : right_->make_value(name, reverse_lhs_op(value, left_->value()));
 	}
 
-	[[nodiscard]] bool contains(const std::string &name) const noexcept {
+	[[nodiscard]] bool contains(std::string_view name) const noexcept {
 		return name_ == name || (left_ && left_->contains(name)) || (right_ && right_->contains(name));
 	}
 };
 
-[[nodiscard]] static Node_Tree read_tree(std::istream &in) {
-	Node_Tree nodes;
-	while (has_input(in)) {
-		auto node_ptr = std::make_unique<Node>(Node::create_from_stream(std::cin));
-		auto name = node_ptr->name();
-		nodes.emplace(std::move(name), std::move(node_ptr));
-	}
-	for (auto &[name, node_ptr] : nodes)
-		node_ptr->link_children(nodes);
+[[nodiscard]] static std::vector<Node> read_nodes(Input_Source &in) {
+	std::vector<Node> nodes;
+	while (has_input(in))
+		nodes.push_back(Node::create_from_input(in));
 	return nodes;
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	auto nodes = read_tree(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << nodes["root"]->value() << std::endl;
-		break;
-	case 2:
-		std::cout << nodes["root"]->make_equal("humn") << std::endl;
-		break;
+[[nodiscard]] static Node_Tree link_tree(std::vector<Node> &nodes) {
+	Node_Tree tree;
+	tree.reserve(nodes.size());
+	for (auto &node : nodes)
+		tree.emplace(node.name(), &node);
+	for (auto &node : nodes)
+		node.link_children(tree);
+	return tree;
+}
+
+/*
+ * The nodes own the monkeys; the tree indexes them by name. Moving the state keeps the node storage, and with it
+ * the tree's pointers, intact.
+ */
+struct Monkey_Tree {
+	std::vector<Node> nodes;
+	Node_Tree tree;
+};
+
+struct Solution {
+	// Both parts memoise values in the shared nodes
+	static constexpr bool INDEPENDENT_PARTS{false};
+
+	static Monkey_Tree parse(Input_Source &input) {
+		Monkey_Tree monkeys{read_nodes(input), {}};
+		monkeys.tree = link_tree(monkeys.nodes);
+		return monkeys;
 	}
-	return 0;
+
+	static long part1(const Monkey_Tree &monkeys) {
+		return monkeys.tree.at("root")->value();
+	}
+
+	static long part2(const Monkey_Tree &monkeys) {
+		return monkeys.tree.at("root")->make_equal("humn");
+	}
+};
+
 }
+
+AOC_SOLUTION(21, Solution)
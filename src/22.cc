@@ -3,42 +3,34 @@
 #include <variant>
 #include <ranges>
 
+namespace {
+
 enum class Direction {
 	RIGHT = 0, DOWN = 1, LEFT = 2, UP = 3
 };
 
-using Grid = std::vector<std::vector<char>>;
+using Board = Grid<char>;
 using Instruction = std::variant<int, Direction>;
 
-[[nodiscard]] static std::vector<Instruction> parse_instructions(const std::string &line) {
+[[nodiscard]] static std::vector<Instruction> parse_instructions(std::string_view line) {
 	std::vector<Instruction> instructions;
-	std::string num_str;
-	for (auto c : line) {
-		if (c == 'R' || c == 'L') {
-			if (!num_str.empty()) {
-				instructions.emplace_back(std::stoi(num_str));
-				num_str.clear();
-			}
-			instructions.emplace_back(c == 'R' ? Direction::RIGHT : Direction::LEFT);
-		} else {
-			num_str += c;
+	std::size_t num_start{0};
+	for (std::size_t pos = 0; pos < line.size(); ++pos) {
+		if (line[pos] == 'R' || line[pos] == 'L') {
+			if (pos != num_start)
+				instructions.emplace_back(parse_number(line.substr(num_start, pos - num_start)));
+			instructions.emplace_back(line[pos] == 'R' ? Direction::RIGHT : Direction::LEFT);
+			num_start = pos + 1;
 		}
 	}
-	if (!num_str.empty())
-		instructions.emplace_back(std::stoi(num_str));
+	if (num_start != line.size())
+		instructions.emplace_back(parse_number(line.substr(num_start)));
 	return instructions;
 }
 
-[[nodiscard]] static Grid flush_grid(Grid grid) {
-	const auto max_ncols = std::ranges::max_element(grid, [](const auto &lhs, const auto &rhs) { return lhs.size() < rhs.size(); })->size();
-	for (auto &row : grid)
-		row.resize(max_ncols, ' ');
-	return grid;
-}
-
 struct Wrapper_2D {
 
-	explicit Wrapper_2D(const Grid &grid) noexcept
+	explicit Wrapper_2D(const Board &grid) noexcept
 			: grid_ptr_{&grid} { }
 
 	[[nodiscard]] std::pair<Grid_Position, Direction> operator()(const Grid_Position &position, Direction direction) const noexcept {
@@ -49,15 +41,15 @@ struct Wrapper_2D {
 		case DOWN:
 			return std::make_pair(find_first_tile(Grid_Position{0, position.c}, position), direction);
 		case LEFT:
-			return std::make_pair(find_first_tile(Grid_Position{position.r, (*grid_ptr_)[position.r].size() - 1}, position), direction);
+			return std::make_pair(find_first_tile(Grid_Position{position.r, grid_ptr_->width() - 1}, position), direction);
 		case UP:
 		default:
-			return std::make_pair(find_first_tile(Grid_Position{grid_ptr_->size() - 1, position.c}, position), direction);
+			return std::make_pair(find_first_tile(Grid_Position{grid_ptr_->height() - 1, position.c}, position), direction);
 		}
 	}
 
 private:
-	const Grid *grid_ptr_;
+	const Board *grid_ptr_;
 
 	[[nodiscard]] Grid_Position find_first_tile(const Grid_Position &start, const Grid_Position &end) const {
 		int r_inc, c_inc;
@@ -78,7 +70,7 @@ private:
 		}
 		for (std::size_t r = start.r; r_eval(r); r += r_inc) {
 			for (std::size_t c = start.c; c_eval(c); c += c_inc) {
-				if ((*grid_ptr_)[r][c] != ' ')
+				if ((*grid_ptr_)(r, c) != ' ')
 					return Grid_Position{r, c};
 			}
 		}
@@ -88,7 +80,7 @@ private:
 
 struct Wrapper_3D {
 
-	explicit Wrapper_3D(const Grid &grid) noexcept
+	explicit Wrapper_3D(const Board &grid) noexcept
 			: grid_ptr_{&grid} { }
 
 	[[nodiscard]] std::pair<Grid_Position, Direction> operator()(const Grid_Position &position, Direction direction) const {
@@ -175,15 +167,15 @@ private:
 		return *face_it;
 	}
 
-	const Grid *grid_ptr_;
+	const Board *grid_ptr_;
 };
 
-[[nodiscard]] static Grid_Position find_first_open(const Grid &grid, const Grid_Position &start, const Grid_Position &end) {
+[[nodiscard]] static Grid_Position find_first_open(const Board &grid, const Grid_Position &start, const Grid_Position &end) {
 	for (std::size_t r = start.r; r <= end.r; ++r) {
 		for (std::size_t c = start.c; c <= end.c; ++c) {
-			if (grid[r][c] == '.')
+			if (grid(r, c) == '.')
 				return Grid_Position{r, c};
-			if (grid[r][c] == '#')
+			if (grid(r, c) == '#')
 				break;
 		}
 	}
@@ -191,7 +183,7 @@ private:
 }
 
 template<class WrapperT>
-[[nodiscard]] static std::pair<Grid_Position, Direction> travel(const Grid &grid, const WrapperT &wrapper, Grid_Position position, Direction direction, int ntiles) {
+[[nodiscard]] static std::pair<Grid_Position, Direction> travel(const Board &grid, const WrapperT &wrapper, Grid_Position position, Direction direction, int ntiles) {
 	for (int tile = 0; tile < ntiles; ++tile) {
 		Grid_Position next_position{position};
 		Direction next_direction{direction};
@@ -199,13 +191,13 @@ template<class WrapperT>
 		switch (direction) {
 		using enum Direction;
 		case RIGHT:
-			if (next_position.c == grid[next_position.r].size() - 1)
+			if (next_position.c == grid.width() - 1)
 				out_of_bounds = true;
 			else
 				++next_position.c;
 			break;
 		case DOWN:
-			if (next_position.r == grid.size() - 1)
+			if (next_position.r == grid.height() - 1)
 				out_of_bounds = true;
 			else
 				++next_position.r;
@@ -224,9 +216,9 @@ template<class WrapperT>
 			break;
 		}
 
-		if (out_of_bounds || grid[next_position.r][next_position.c] == ' ')
+		if (out_of_bounds || grid[next_position] == ' ')
 			std::tie(next_position, next_direction) = wrapper(position, direction);
-		if (grid[next_position.r][next_position.c] == '#')
+		if (grid[next_position] == '#')
 			return std::make_pair(position, direction);
 		position = next_position;
 		direction = next_direction;
@@ -235,8 +227,8 @@ template<class WrapperT>
 }
 
 template<class WrapperT>
-[[nodiscard]] static int password(const Grid &grid, const std::vector<Instruction> &instructions, const WrapperT &wrapper) {
-	auto current_pos = find_first_open(grid, Grid_Position{0, 0}, Grid_Position{0, grid.size() - 1});
+[[nodiscard]] static int password(const Board &grid, const std::vector<Instruction> &instructions, const WrapperT &wrapper) {
+	auto current_pos = find_first_open(grid, Grid_Position{0, 0}, Grid_Position{0, grid.width() - 1});
 	auto current_dir = Direction::RIGHT;
 	for (const auto &instruction : instructions) {
 		if (std::holds_alternative<Direction>(instruction)) {
@@ -252,16 +244,26 @@ template<class WrapperT>
 	return 1000 * (current_pos.r + 1) + 4 * (current_pos.c + 1) + static_cast<int>(current_dir);
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto grid = flush_grid(read_grid(std::cin));
-	switch (part) {
-	case 1:
-		std::cout << password(grid, parse_instructions(read_line(std::cin)), Wrapper_2D{grid}) << std::endl;
-		break;
-	case 2:
-		std::cout << password(grid, parse_instructions(read_line(std::cin)), Wrapper_3D{grid}) << std::endl;
-		break;
+struct Notes {
+	Board grid;
+	std::vector<Instruction> instructions;
+};
+
+struct Solution {
+	static Notes parse(Input_Source &input) {
+		auto grid = read_grid(input);
+		return Notes{std::move(grid), parse_instructions(read_line(input))};
 	}
-	return 0;
+
+	static int part1(const Notes &notes) {
+		return password(notes.grid, notes.instructions, Wrapper_2D{notes.grid});
+	}
+
+	static int part2(const Notes &notes) {
+		return password(notes.grid, notes.instructions, Wrapper_3D{notes.grid});
+	}
+};
+
 }
+
+AOC_SOLUTION(22, Solution)
@@ -1,11 +1,21 @@
 #include "common.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <future>
 #include <limits>
-#include <unordered_set>
+#include <optional>
+#include <ranges>
+#include <vector>
 
-static std::vector<Position> read_positions(std::istream &in) {
+namespace {
+
+static std::vector<Position> read_positions(Input_Source &in) {
 	std::vector<Position> positions;
 	int y{0};
-	for (std::string line; std::getline(in, line); ++y) {
+	for (; has_input(in); ++y) {
+		const auto line = read_line(in);
 		for (int x = 0; x < static_cast<int>(line.size()); ++x) {
 			if (line[x] == '#')
 				positions.push_back(Position{x, y});
@@ -14,131 +24,284 @@ static std::vector<Position> read_positions(std::istream &in) {
 	return positions;
 }
 
-struct Move {
-	using Check_Func = std::function<bool(const Position &)>;
+enum Direction : std::size_t {
+	NORTH, SOUTH, WEST, EAST
+};
+
+/*
+ * A row's bits moved SHIFT columns east, so that bit x holds column x - SHIFT, or west, so that it holds x + SHIFT,
+ * carrying across words.
+ */
+template<int SHIFT>
+[[nodiscard]] static std::uint64_t from_west(const std::uint64_t *row, std::size_t i) noexcept {
+	return (row[i] << SHIFT) | (i > 0 ? row[i - 1] >> (64 - SHIFT) : 0);
+}
+
+template<int SHIFT>
+[[nodiscard]] static std::uint64_t from_east(const std::uint64_t *row, std::size_t i, std::size_t words) noexcept {
+	return (row[i] >> SHIFT) | (i + 1 < words ? row[i + 1] << (64 - SHIFT) : 0);
+}
 
-	explicit Move(const Check_Func &check_blocked, const Position &move_inc)
-		: check_blocked_{check_blocked},
-		  move_inc_{move_inc} {}
+/*
+ * The elves as a bitboard, one run of 64-bit words per row, bit x of a row standing for its xth column.
+ * A round works on whole words: the elves with each group of three neighbours free are found with shifts, and each
+ * elf proposes the first free direction in the round's order. An elf can only propose a cell no elf beside it could
+ * also reach, so the only collisions are between elves two cells apart proposing to meet in the middle, found by
+ * comparing the north proposals with the south ones two rows up and the west proposals with the east ones two
+ * columns over.
+ *
+ * The outermost rows and columns are kept empty so no elf steps off the board, which grows whenever an elf reaches
+ * them.
+ */
+struct Elf_Board {
+	// Fewest rows worth handing to a worker as a band
+	static constexpr int MIN_BAND_ROWS{64};
 
-	[[nodiscard]]
-	bool can_move(const Position &position) const noexcept {
-		return !check_blocked_(position);
+	explicit Elf_Board(const std::vector<Position> &positions) {
+		if (positions.empty())
+			return;
+		const auto [min_x, max_x] = std::ranges::minmax(positions | std::views::transform(&Position::x));
+		const auto [min_y, max_y] = std::ranges::minmax(positions | std::views::transform(&Position::y));
+		height_ = max_y - min_y + 1;
+		words_ = static_cast<std::size_t>(max_x - min_x) / 64 + 1;
+		cells_.assign(height_ * words_, 0);
+		for (const auto &position : positions) {
+			const auto x = static_cast<std::size_t>(position.x - min_x);
+			cells_[(position.y - min_y) * words_ + x / 64] |= std::uint64_t{1} << (x % 64);
+		}
+		empty_row_.assign(words_, 0);
+		grow_to_fit();
 	}
 
-	[[nodiscard]]
-	Position move(const Position &position) const noexcept {
-		return Position{position.x + move_inc_.x, position.y + move_inc_.y};
+	/*
+	 * Plays one round and reports whether any elf moved.
+	 */
+	bool run_round() {
+		begin_round();
+		propose_rows(0, height_);
+		return end_round(move_rows(0, height_));
 	}
 
-private:
-	Check_Func check_blocked_;
-	Position move_inc_;
-};
+	/*
+	 * Plays one round with the rows split into bands across the pool. Every band makes its proposals before any band
+	 * moves, as the moves near a band's edge read proposals up to two rows beyond it; the planes are shared, so no
+	 * halo rows are copied. Each row is computed exactly as in the serial round, so the result is the same.
+	 */
+	bool run_round(Thread_Pool &pool) {
+		const auto num_bands = std::clamp<int>(height_ / MIN_BAND_ROWS, 1, static_cast<int>(pool.size() * BANDS_PER_WORKER));
+		if (num_bands == 1)
+			return run_round();
+		begin_round();
+		const auto band_start = [this, num_bands](int band) {
+			return static_cast<int>(static_cast<std::int64_t>(height_) * band / num_bands);
+		};
 
-static int count_empty(const std::unordered_set<Position> &position_set) {
-	const auto min_y = std::ranges::min_element(position_set, [](const auto &lhs, const auto &rhs) { return lhs.y < rhs.y; })->y;
-	const auto max_y = std::ranges::max_element(position_set, [](const auto &lhs, const auto &rhs) { return lhs.y < rhs.y; })->y;
-	const auto min_x = std::ranges::min_element(position_set, [](const auto &lhs, const auto &rhs) { return lhs.x < rhs.x; })->x;
-	const auto max_x = std::ranges::max_element(position_set, [](const auto &lhs, const auto &rhs) { return lhs.x < rhs.x; })->x;
-
-	int count{0};
-	for (int y = min_y; y <= max_y; ++y) {
-		for (int x = min_x; x <= max_x; ++x) {
-			if (!position_set.contains(Position{x, y}))
-				++count;
+		std::vector<std::future<void>> proposing;
+		for (int band = 0; band < num_bands; ++band) {
+			proposing.push_back(pool.submit([this, first = band_start(band), last = band_start(band + 1)] {
+				propose_rows(first, last);
+			}));
 		}
-	}
-	return count;
-}
+		for (auto &band : proposing)
+			pool.wait_for(band);
 
-static std::pair<std::unordered_set<Position>, int> run_process(const std::vector<Position> &positions,
-																std::size_t max_rounds = std::numeric_limits<std::size_t>::max()) {
-	std::unordered_set<Position> position_set{positions.begin(), positions.end()};
-	Circular_Queue<Move> moves{std::vector<Move>{
-		Move{
-			[&position_set](const Position &position) {
-				return position_set.contains(Position{position.x - 1, position.y - 1})
-					|| position_set.contains(Position{position.x, position.y - 1})
-					|| position_set.contains(Position{position.x + 1, position.y - 1});
-			},
-			Position{0, -1}
-		},
-		Move{
-			[&position_set](const Position &position) {
-				return position_set.contains(Position{position.x - 1, position.y + 1})
-					|| position_set.contains(Position{position.x, position.y + 1})
-					|| position_set.contains(Position{position.x + 1, position.y + 1});
-			},
-			Position{0, 1}
-		},
-		Move{
-			[&position_set](const Position &position) {
-				return position_set.contains(Position{position.x - 1, position.y - 1})
-					|| position_set.contains(Position{position.x - 1, position.y})
-					|| position_set.contains(Position{position.x - 1, position.y + 1});
-			},
-			Position{-1, 0}
-		},
-		Move{
-			[&position_set](const Position &position) {
-				return position_set.contains(Position{position.x + 1, position.y - 1})
-					|| position_set.contains(Position{position.x + 1, position.y})
-					|| position_set.contains(Position{position.x + 1, position.y + 1});
-			},
-			Position{1, 0}
+		std::vector<std::future<std::size_t>> moving;
+		for (int band = 0; band < num_bands; ++band) {
+			moving.push_back(pool.submit([this, first = band_start(band), last = band_start(band + 1)] {
+				return move_rows(first, last);
+			}));
 		}
-	}};
+		std::size_t moves{0};
+		for (auto &band : moving)
+			moves += pool.wait_for(band);
+		return end_round(moves);
+	}
 
-	for (std::size_t round = 1; round <= max_rounds; ++round) {
-		std::unordered_map<Position, std::vector<Position>> proposed_moves;
-		for (const auto &position : position_set) {
-			if (position_set.contains(Position{position.x - 1, position.y - 1})
-					|| position_set.contains(Position{position.x, position.y - 1})
-					|| position_set.contains(Position{position.x + 1, position.y - 1})
-					|| position_set.contains(Position{position.x - 1, position.y})
-					|| position_set.contains(Position{position.x + 1, position.y})
-					|| position_set.contains(Position{position.x - 1, position.y + 1})
-					|| position_set.contains(Position{position.x, position.y + 1})
-					|| position_set.contains(Position{position.x + 1, position.y + 1})) {
-				auto moves_cpy{moves};
-				for (std::size_t i = 0; i < moves_cpy.size(); ++i) {
-					const auto &move = moves_cpy.take();
-					if (move.can_move(position)) {
-						proposed_moves[move.move(position)].push_back(position);
-						break;
-					}
-				}
+	[[nodiscard]] int height() const noexcept {
+		return height_;
+	}
+
+	/*
+	 * Empty cells in the smallest rectangle holding every elf.
+	 */
+	[[nodiscard]] int count_empty() const noexcept {
+		int min_y{height_}, max_y{-1}, num_elves{0};
+		std::vector<std::uint64_t> columns(words_);
+		for (int y = 0; y < height_; ++y) {
+			const auto cells = row(cells_, y);
+			int row_elves{0};
+			for (std::size_t i = 0; i < words_; ++i) {
+				row_elves += std::popcount(cells[i]);
+				columns[i] |= cells[i];
+			}
+			if (row_elves > 0) {
+				min_y = std::min(min_y, y);
+				max_y = y;
+				num_elves += row_elves;
 			}
 		}
+		if (num_elves == 0)
+			return 0;
+		const auto first_word = std::ranges::find_if(columns, [](auto word) { return word != 0; }) - columns.begin();
+		const auto last_word = columns.rend() - std::ranges::find_if(columns.rbegin(), columns.rend(), [](auto word) { return word != 0; }) - 1;
+		const auto min_x = 64 * first_word + std::countr_zero(columns[first_word]);
+		const auto max_x = 64 * last_word + 63 - std::countl_zero(columns[last_word]);
+		return (max_y - min_y + 1) * static_cast<int>(max_x - min_x + 1) - num_elves;
+	}
+
+private:
+	static constexpr int MIN_ROW_GROWTH{16};
+	static constexpr std::size_t BANDS_PER_WORKER{4};
+
+	int height_{0};
+	std::size_t words_{1};
+	std::size_t round_{0};
+	std::vector<std::uint64_t> cells_, next_;
+	std::array<std::vector<std::uint64_t>, 4> proposals_;
+	std::vector<std::uint64_t> empty_row_;
+
+	/*
+	 * A row of a plane laid out like the board; rows off the board read as empty.
+	 */
+	[[nodiscard]] const std::uint64_t *row(const std::vector<std::uint64_t> &plane, int y) const noexcept {
+		return 0 <= y && y < height_ ? plane.data() + y * words_ : empty_row_.data();
+	}
+
+	void begin_round() {
+		AOC_COUNT("run_process: rounds", 1);
+		for (auto &proposals : proposals_)
+			proposals.resize(cells_.size());
+		next_.resize(cells_.size());
+	}
 
-		int num_moves{0};
-		for (const auto &[proposed_position, source_positions] : proposed_moves) {
-			if (source_positions.size() == 1) {
-				position_set.erase(source_positions.front());
-				position_set.insert(proposed_position);
-				++num_moves;
+	bool end_round(std::size_t moves) {
+		AOC_COUNT("run_process: moves", moves);
+		std::swap(cells_, next_);
+		++round_;
+		grow_to_fit();
+		return moves > 0;
+	}
+
+	void propose_rows(int first, int last) noexcept {
+		for (int y = first; y < last; ++y)
+			propose_row(y);
+	}
+
+	std::size_t move_rows(int first, int last) noexcept {
+		std::size_t moves{0};
+		for (int y = first; y < last; ++y)
+			moves += move_row(y);
+		return moves;
+	}
+
+	void propose_row(int y) noexcept {
+		const auto north = row(cells_, y - 1), cells = row(cells_, y), south = row(cells_, y + 1);
+		const auto first = round_ % 4;
+		for (std::size_t i = 0; i < words_; ++i) {
+			const auto west = from_west<1>(north, i) | from_west<1>(cells, i) | from_west<1>(south, i);
+			const auto east = from_east<1>(north, i, words_) | from_east<1>(cells, i, words_) | from_east<1>(south, i, words_);
+			const std::array<std::uint64_t, 4> blocked{
+				north[i] | from_west<1>(north, i) | from_east<1>(north, i, words_),
+				south[i] | from_west<1>(south, i) | from_east<1>(south, i, words_),
+				west,
+				east
+			};
+			auto undecided = cells[i] & (blocked[NORTH] | blocked[SOUTH] | west | east);
+			for (std::size_t k = 0; k < 4; ++k) {
+				const auto direction = (first + k) % 4;
+				const auto proposed = undecided & ~blocked[direction];
+				proposals_[direction][y * words_ + i] = proposed;
+				undecided &= ~proposed;
 			}
 		}
-		if (num_moves == 0)
-			return std::make_pair(position_set, round);
+	}
 
-		moves.next();
+	std::size_t move_row(int y) noexcept {
+		const auto cells = row(cells_, y);
+		const auto north = row(proposals_[NORTH], y), south = row(proposals_[SOUTH], y);
+		const auto west = row(proposals_[WEST], y), east = row(proposals_[EAST], y);
+		const auto north_up_two = row(proposals_[SOUTH], y - 2), south_down_two = row(proposals_[NORTH], y + 2);
+		const auto north_from_below = row(proposals_[NORTH], y + 1), south_from_above = row(proposals_[SOUTH], y - 1);
+		auto next = next_.data() + y * words_;
+		std::size_t moves{0};
+		for (std::size_t i = 0; i < words_; ++i) {
+			const auto leaving = (north[i] & ~north_up_two[i]) | (south[i] & ~south_down_two[i])
+					| (west[i] & ~from_west<2>(east, i)) | (east[i] & ~from_east<2>(west, i, words_));
+			const auto west_in = from_east<1>(west, i, words_), east_in = from_west<1>(east, i);
+			const auto arriving = (north_from_below[i] & ~south_from_above[i]) | (south_from_above[i] & ~north_from_below[i])
+					| (west_in & ~east_in) | (east_in & ~west_in);
+			next[i] = (cells[i] & ~leaving) | arriving;
+			moves += std::popcount(leaving);
+		}
+		return moves;
 	}
 
-	return std::make_pair(position_set, max_rounds);
+	/*
+	 * Grows the board so that its outermost rows and columns are empty again.
+	 */
+	void grow_to_fit() {
+		if (height_ == 0)
+			return;
+		const auto row_has_elves = [this](int y) {
+			const auto cells = row(cells_, y);
+			return std::any_of(cells, cells + words_, [](auto word) { return word != 0; });
+		};
+		bool left{false}, right{false};
+		for (int y = 0; y < height_; ++y) {
+			left |= (row(cells_, y)[0] & 1) != 0;
+			right |= (row(cells_, y)[words_ - 1] >> 63) != 0;
+		}
+		const auto row_growth = std::max(MIN_ROW_GROWTH, height_ / 8);
+		const auto top = row_has_elves(0) ? row_growth : 0, bottom = row_has_elves(height_ - 1) ? row_growth : 0;
+		const std::size_t left_words = left ? 1 : 0, right_words = right ? 1 : 0;
+		if (top + bottom + left_words + right_words == 0)
+			return;
+
+		AOC_COUNT("run_process: board growths", 1);
+		const auto words = words_ + left_words + right_words;
+		std::vector<std::uint64_t> cells((height_ + top + bottom) * words, 0);
+		for (int y = 0; y < height_; ++y)
+			std::copy_n(row(cells_, y), words_, cells.begin() + (y + top) * words + left_words);
+		cells_ = std::move(cells);
+		height_ += top + bottom;
+		words_ = words;
+		empty_row_.assign(words_, 0);
+	}
+};
+
+/*
+ * Plays rounds until no elf moves or max_rounds have been played. Fields tall enough to split into bands are played
+ * on a pool of num_threads workers.
+ */
+static std::pair<Elf_Board, std::size_t> run_process(const std::vector<Position> &positions,
+													 std::size_t max_rounds = std::numeric_limits<std::size_t>::max(),
+													 std::size_t num_threads = default_thread_count()) {
+	AOC_TIMER("run_process");
+	Elf_Board board{positions};
+	std::optional<Thread_Pool> pool;
+	if (num_threads > 1 && board.height() >= 2 * Elf_Board::MIN_BAND_ROWS)
+		pool.emplace(num_threads);
+	for (std::size_t round = 1; round <= max_rounds; ++round) {
+		if (!(pool ? board.run_round(*pool) : board.run_round()))
+			return std::make_pair(std::move(board), round);
+	}
+	return std::make_pair(std::move(board), max_rounds);
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto positions = read_positions(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << count_empty(run_process(positions, 10).first) << std::endl;
-		break;
-	case 2:
-		std::cout << run_process(positions).second << std::endl;
-		break;
-	}
-	return 0;
+struct Solution {
+	static std::vector<Position> parse(Input_Source &input) {
+		return read_positions(input);
+	}
+
+	static int part1(const std::vector<Position> &positions) {
+		return run_process(positions, 10).first.count_empty();
+	}
+
+	static std::size_t part2(const std::vector<Position> &positions) {
+		return run_process(positions).second;
+	}
+};
+
 }
+
+AOC_SOLUTION(23, Solution)
@@ -1,51 +1,80 @@
 #include "common.h"
-#include <limits>
-#include <queue>
-#include <unordered_set>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
-enum class Direction {
-	RIGHT, LEFT, DOWN, UP
-};
+namespace {
 
-struct Cloud {
-
-	Cloud(const Position &init_pos, Direction direction) noexcept
-		: init_pos_{init_pos}
-		, direction_{direction} {}
-	
-	[[nodiscard]] Position current_position(int time, int area_width, int area_height) const noexcept {
-		Position position{init_pos_};
-		switch (direction_) {
-		using enum Direction;
-		case RIGHT:
-			position.x = (position.x + time) % area_width;
-			break;
-		case LEFT:
-			position.x = (position.x + area_width - (time % area_width)) % area_width;
-			break;
-		case DOWN:
-			position.y = (position.y + time) % area_height;
-			break;
-		case UP:
-			position.y = (position.y + area_height - (time % area_height)) % area_height;
-			break;
-		}
-		return position;
+/*
+ * Equal-length lines of bits packed into 64-bit words, one run of words per line.
+ */
+struct Bit_Lines {
+
+	Bit_Lines(int num_lines, int line_length)
+		: words_per_line_{static_cast<std::size_t>(line_length + 63) / 64}
+		, words_(num_lines * words_per_line_) {}
+
+	[[nodiscard]] std::size_t words_per_line() const noexcept {
+		return words_per_line_;
+	}
+
+	[[nodiscard]] std::uint64_t *line(int line) noexcept {
+		return words_.data() + line * words_per_line_;
 	}
 
+	[[nodiscard]] const std::uint64_t *line(int line) const noexcept {
+		return words_.data() + line * words_per_line_;
+	}
+
+	void set(int line, int bit) noexcept {
+		words_[line * words_per_line_ + bit / 64] |= std::uint64_t{1} << (bit % 64);
+	}
+
+	[[nodiscard]] bool test(int line, int bit) const noexcept {
+		return (words_[line * words_per_line_ + bit / 64] >> (bit % 64)) & 1;
+	}
+
+	void clear() noexcept {
+		std::fill(words_.begin(), words_.end(), 0);
+	}
+
+	[[nodiscard]] bool operator==(const Bit_Lines &other) const noexcept = default;
+
 private:
-	Position init_pos_;
-	Direction direction_;
+	std::size_t words_per_line_;
+	std::vector<std::uint64_t> words_;
 };
 
+/*
+ * The 64 bits of a line starting at the given bit, which may straddle two words.
+ */
+[[nodiscard]] static std::uint64_t extract_word(const std::uint64_t *line, std::size_t bit) noexcept {
+	const auto word = bit / 64, offset = bit % 64;
+	return offset == 0 ? line[word] : (line[word] >> offset) | (line[word + 1] << (64 - offset));
+}
+
+/*
+ * Where the blizzards start, as one bitmask of columns per row for each direction. A blizzard only ever moves along
+ * its own row or column and wraps with that line's length, so at time t the horizontal blizzards in a row are its
+ * starting masks rotated t columns, and the vertical ones are the starting masks of the rows t rows upstream. The
+ * horizontal masks are stored twice over, back to back, so a rotation is a read at an offset.
+ */
 struct Blizzard {
 
-	Blizzard(std::vector<Cloud> clouds, int width, int height) noexcept
-		: clouds_{std::move(clouds)}
+	Blizzard(int width, int height)
+		: right_{height, 2 * width + 64}
+		, left_{height, 2 * width + 64}
+		, down_{height, width}
+		, up_{height, width}
 		, width_{width}
 		, height_{height} {}
-	
+
 	[[nodiscard]] int width() const noexcept {
 		return width_;
 	}
@@ -54,114 +83,305 @@ struct Blizzard {
 		return height_;
 	}
 
+	[[nodiscard]] std::size_t words_per_row() const noexcept {
+		return down_.words_per_line();
+	}
+
 	[[nodiscard]] Position determine_goal() const noexcept {
 		return Position{width_ - 1, height_};
 	}
 
-	[[nodiscard]] std::unordered_set<Position> cloud_positions(int time) const {
-		std::unordered_set<Position> positions;
-		std::ranges::transform(clouds_, std::inserter(positions, positions.end()),
-				[this, time](const auto &cloud) { return cloud.current_position(time, width_, height_); });
-		return positions;
+	void add_cloud(const Position &position, char direction) {
+		switch (direction) {
+		case '>':
+			right_.set(position.y, position.x);
+			right_.set(position.y, position.x + width_);
+			break;
+		case '<':
+			left_.set(position.y, position.x);
+			left_.set(position.y, position.x + width_);
+			break;
+		case 'v':
+			down_.set(position.y, position.x);
+			break;
+		case '^':
+			up_.set(position.y, position.x);
+			break;
+		default:
+			throw std::invalid_argument{std::string{"Invalid blizzard direction: "} + direction};
+		}
+	}
+
+	/*
+	 * Whether no blizzard covers the position at the given time. Cells outside the valley (the entrance and exit) are
+	 * always clear.
+	 */
+	[[nodiscard]] bool is_clear(const Position &position, int time) const noexcept {
+		const auto x = position.x, y = position.y;
+		if (x < 0 || x >= width_ || y < 0 || y >= height_)
+			return true;
+		const auto dx = time % width_, dy = time % height_;
+		return !right_.test(y, x + width_ - dx) && !left_.test(y, x + dx)
+				&& !down_.test((y + height_ - dy) % height_, x) && !up_.test((y + dy) % height_, x);
+	}
+
+	/*
+	 * Fills words_per_row() words with the columns of row y that a blizzard covers at the given time.
+	 */
+	void covered_row(int y, int time, std::uint64_t *covered) const noexcept {
+		const std::size_t dx = time % width_, dy = time % height_;
+		const auto right = right_.line(y), left = left_.line(y);
+		const auto down = down_.line((y + height_ - dy) % height_), up = up_.line((y + dy) % height_);
+		for (std::size_t i = 0; i < words_per_row(); ++i) {
+			covered[i] = extract_word(right, width_ - dx + 64 * i) | extract_word(left, dx + 64 * i)
+					| down[i] | up[i];
+		}
 	}
 
 private:
-	std::vector<Cloud> clouds_;
+	Bit_Lines right_, left_, down_, up_;
 	int width_, height_;
 };
 
-static Blizzard read_input(std::istream &in) {
-	int width{};
-	std::vector<Cloud> clouds;
-	int y{0};
-	for (std::string line; std::getline(in, line); ++y) {
-		width = line.size() - 2;
-		for (int x = 0; x < static_cast<int>(line.size()); ++x) {
-			switch (line[x]) {
-			case '>':
-				clouds.emplace_back(Position{x - 1, y - 1}, Direction::RIGHT);
-				break;
-			case '<':
-				clouds.emplace_back(Position{x - 1, y - 1}, Direction::LEFT);
-				break;
-			case 'v':
-				clouds.emplace_back(Position{x - 1, y - 1}, Direction::DOWN);
-				break;
-			case '^':
-				clouds.emplace_back(Position{x - 1, y - 1}, Direction::UP);
-				break;
-			}
+static Blizzard read_input(Input_Source &in) {
+	std::vector<std::string> lines;
+	while (has_input(in))
+		lines.emplace_back(read_line(in));
+	if (lines.size() < 3 || lines.front().size() < 3)
+		throw std::invalid_argument{"Valley too small"};
+
+	Blizzard blizzard{static_cast<int>(lines.front().size()) - 2, static_cast<int>(lines.size()) - 2};
+	for (int y = 1; y + 1 < static_cast<int>(lines.size()); ++y) {
+		for (int x = 1; x + 1 < static_cast<int>(lines[y].size()); ++x) {
+			if (lines[y][x] != '.')
+				blizzard.add_cloud(Position{x - 1, y - 1}, lines[y][x]);
 		}
 	}
-	return Blizzard{std::move(clouds), width, y - 2};
+	return blizzard;
 }
 
-struct Node {
-	Position position;
-	int time;
+[[nodiscard]] static bool is_opening(const Blizzard &blizzard, const Position &position) noexcept {
+	return 0 <= position.x && position.x < blizzard.width() && (position.y == -1 || position.y == blizzard.height());
+}
 
-	[[nodiscard]] bool operator==(const Node &other) const noexcept {
-		return position == other.position && time == other.time;
-	}
-};
+[[nodiscard]] static bool in_valley(const Blizzard &blizzard, const Position &position) noexcept {
+	return 0 <= position.x && position.x < blizzard.width() && 0 <= position.y && position.y < blizzard.height();
+}
 
-struct Node_Hasher {
-	[[nodiscard]] std::size_t operator()(const Node &node) const noexcept {
-		return std::hash<std::string>{}(std::to_string(node.position.x) + "," + std::to_string(node.position.y) + "," + std::to_string(node.time));
+/*
+ * The valley cell next to an entrance or exit in the top or bottom wall.
+ */
+[[nodiscard]] static Position opening_neighbour(const Blizzard &blizzard, const Position &opening) noexcept {
+	return Position{opening.x, opening.y < 0 ? 0 : blizzard.height() - 1};
+}
+
+/*
+ * Plans trips through a list of waypoints with a breadth-first search over every cell at once. The cells that can be
+ * occupied at each minute form one bitmask per row, and the next minute's are those cells or their neighbours, less
+ * whatever the blizzards then cover. The covered cells of each minute of the blizzard period are cached as they are
+ * first needed (up to a memory budget) and shared by every leg and every trip.
+ *
+ * A trip is one pass through time with a frontier per leg: frontier k holds the cells reachable having visited the
+ * first k + 1 waypoints, and takes in waypoint k + 1 whenever frontier k reaches it. Waiting at an entrance or exit is
+ * always possible, so a frontier that has reached one outgrows every earlier frontier, and those are dropped. An
+ * interior waypoint may be reached at several times that suit the rest of the trip differently, so the frontiers
+ * before it keep running.
+ */
+struct Trip_Planner {
+	static constexpr std::size_t CACHE_BYTES{std::size_t{64} << 20};
+
+	explicit Trip_Planner(const Blizzard &blizzard, std::size_t cache_bytes = CACHE_BYTES)
+		: blizzard_{blizzard}
+		, period_{std::lcm(blizzard.width(), blizzard.height())}
+		, minute_words_{blizzard.height() * blizzard.words_per_row()}
+		, cache_capacity_{static_cast<int>(std::min<std::size_t>(period_, cache_bytes / (minute_words_ * sizeof(std::uint64_t))))}
+		, cached_(cache_capacity_, 0)
+		, scratch_(minute_words_) {}
+
+	/*
+	 * The earliest time each waypoint after the first can be reached on a trip that leaves the first, which must be
+	 * the entrance or exit, at init_time and visits them in order.
+	 */
+	std::vector<int> arrival_times(std::span<const Position> waypoints, int init_time = 0) {
+		AOC_TIMER("arrival_times");
+		if (waypoints.empty() || !is_opening(blizzard_, waypoints.front()))
+			throw std::invalid_argument{"A trip must start at the entrance or exit"};
+		for (const auto &waypoint : waypoints) {
+			if (!is_opening(blizzard_, waypoint) && !in_valley(blizzard_, waypoint))
+				throw std::invalid_argument{"Waypoint outside the valley"};
+		}
+		const auto legs = waypoints.size() - 1;
+		std::vector<int> arrivals(legs, -1);
+		if (legs == 0)
+			return arrivals;
+
+		std::vector<Frontier> frontiers;
+		frontiers.push_back(Frontier{empty_cells(), true});
+		std::size_t first_live{0};
+		std::vector<Frontier> checkpoint;
+		Bit_Lines next{empty_cells()};
+		std::vector<std::size_t> leaving;
+		for (auto time = init_time;; ++time) {
+			// Waypoints reached now: an interior cell, or an opening the frontier is already waiting at
+			for (auto k = first_live; k < std::min(frontiers.size(), legs); ++k) {
+				const auto &target = waypoints[k + 1];
+				const auto reached = is_opening(blizzard_, target)
+						? frontiers[k].waiting && waypoints[k] == target
+						: frontiers[k].cells.test(target.y, target.x);
+				if (reached)
+					arrive(frontiers, k, first_live, arrivals, waypoints, time);
+			}
+			if (arrivals.back() >= 0)
+				return arrivals;
+
+			if ((time - init_time) % period_ == 0) {
+				if (time > init_time && frontiers == checkpoint)
+					throw std::runtime_error{"Never reached goal"};
+				checkpoint = frontiers;
+			}
+			AOC_COUNT("arrival_times: minutes stepped", 1);
+
+			// Openings whose neighbour is reachable now are reached next minute
+			leaving.clear();
+			for (auto k = first_live; k < std::min(frontiers.size(), legs); ++k) {
+				const auto &target = waypoints[k + 1];
+				if (is_opening(blizzard_, target) && !(frontiers[k].waiting && waypoints[k] == target)) {
+					const auto neighbour = opening_neighbour(blizzard_, target);
+					if (frontiers[k].cells.test(neighbour.y, neighbour.x))
+						leaving.push_back(k);
+				}
+			}
+
+			const auto covered = covered_cells(time + 1);
+			for (auto k = first_live; k < frontiers.size(); ++k) {
+				step(frontiers[k].cells, next, covered);
+				if (frontiers[k].waiting) {
+					const auto entry = opening_neighbour(blizzard_, waypoints[k]);
+					if (blizzard_.is_clear(entry, time + 1))
+						next.set(entry.y, entry.x);
+				}
+				std::swap(frontiers[k].cells, next);
+			}
+			for (auto k : leaving)
+				arrive(frontiers, k, first_live, arrivals, waypoints, time + 1);
+		}
 	}
-};
 
-static bool in_bounds(const Position &position, int width, int height, const Position &start, const Position &goal) {
-	return position == start || position == goal || (0 <= position.x && position.x < width && 0 <= position.y && position.y < height);
-}
+private:
+	struct Frontier {
+		Bit_Lines cells;
+		bool waiting;
 
-static int min_time(const Blizzard &blizzard, const Position &start, const Position &goal, int init_time = 0) {
-	const auto compare_nodes = [&start](const Node &lhs, const Node &rhs) {
-		return lhs.time - (std::abs(lhs.position.x - start.x) + std::abs(lhs.position.y - start.y))
-					> rhs.time - (std::abs(rhs.position.x - start.x) + std::abs(rhs.position.y - start.y));
+		[[nodiscard]] bool operator==(const Frontier &other) const noexcept = default;
 	};
 
-	std::priority_queue<Node, std::vector<Node>, decltype(compare_nodes)> to_visit{compare_nodes};
-	std::unordered_set<Node, Node_Hasher> visited;
-	to_visit.push(Node{start, init_time});
-	visited.insert(Node{start, init_time});
-	while (!to_visit.empty()) {
-		const auto node = to_visit.top();
-		to_visit.pop();
-		if (node.position == goal)
-			return node.time;
-
-		const auto next_time = node.time + 1;
-		const auto cloud_positions = blizzard.cloud_positions(next_time);
-		for (const auto position : {Position{node.position.x, node.position.y},
-									Position{node.position.x + 1, node.position.y},
-									Position{node.position.x - 1, node.position.y},
-									Position{node.position.x, node.position.y + 1},
-									Position{node.position.x, node.position.y - 1}}) {
-			const Node next_node{position, next_time};
-			if (in_bounds(position, blizzard.width(), blizzard.height(), start, goal)
-					&& !cloud_positions.contains(position)
-					&& !visited.contains(next_node)) {
-				to_visit.push(next_node);
-				visited.insert(next_node);
+	const Blizzard &blizzard_;
+	int period_;
+	std::size_t minute_words_;
+	int cache_capacity_;
+	std::vector<std::uint8_t> cached_;
+	std::vector<std::uint64_t> cache_;
+	std::vector<std::uint64_t> scratch_;
+
+	[[nodiscard]] Bit_Lines empty_cells() const {
+		return Bit_Lines{blizzard_.height(), blizzard_.width()};
+	}
+
+	/*
+	 * Frontier k has reached its target: the next frontier takes it in, or starts waiting at it if it is an opening,
+	 * in which case every frontier up to k is outgrown.
+	 */
+	void arrive(std::vector<Frontier> &frontiers, std::size_t k, std::size_t &first_live, std::vector<int> &arrivals,
+			std::span<const Position> waypoints, int time) {
+		if (arrivals[k] < 0)
+			arrivals[k] = time;
+		if (frontiers.size() == k + 1)
+			frontiers.push_back(Frontier{empty_cells(), false});
+		const auto &target = waypoints[k + 1];
+		if (is_opening(blizzard_, target)) {
+			frontiers[k + 1].waiting = true;
+			for (; first_live <= k; ++first_live)
+				frontiers[first_live] = Frontier{empty_cells(), false};
+		} else {
+			frontiers[k + 1].cells.set(target.y, target.x);
+		}
+	}
+
+	/*
+	 * The cells the blizzards cover at the given time, one run of words per row.
+	 */
+	const std::uint64_t *covered_cells(int time) {
+		const auto minute = time % period_;
+		auto *covered = scratch_.data();
+		if (minute < cache_capacity_) {
+			if (cache_.empty())
+				cache_.resize(cache_capacity_ * minute_words_);
+			covered = cache_.data() + minute * minute_words_;
+			if (cached_[minute]) {
+				AOC_COUNT("arrival_times: cached minutes", 1);
+				return covered;
 			}
+			cached_[minute] = 1;
 		}
+		for (int y = 0; y < blizzard_.height(); ++y)
+			blizzard_.covered_row(y, time, covered + y * blizzard_.words_per_row());
+		return covered;
 	}
-	throw std::runtime_error{"Never reached goal"};
-}
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto blizzard = read_input(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << min_time(blizzard, Position{0, -1}, blizzard.determine_goal()) << std::endl;
-		break;
-	case 2:
-		std::cout << min_time(blizzard, Position{0, -1}, blizzard.determine_goal(),
-						min_time(blizzard, blizzard.determine_goal(), Position{0, -1},
-							min_time(blizzard, Position{0, -1}, blizzard.determine_goal()))) << std::endl;
-		break;
-	}
-	return 0;
+	/*
+	 * The cells reachable a minute after those in from, given the cells the blizzards then cover.
+	 */
+	void step(const Bit_Lines &from, Bit_Lines &to, const std::uint64_t *covered) const noexcept {
+		const auto height = blizzard_.height(), words = static_cast<int>(blizzard_.words_per_row());
+		const auto width_bits = blizzard_.width() % 64;
+		const auto last_word_mask = width_bits == 0 ? ~std::uint64_t{0} : (std::uint64_t{1} << width_bits) - 1;
+		for (int y = 0; y < height; ++y) {
+			const auto row = from.line(y);
+			const auto covered_row = covered + y * words;
+			auto to_row = to.line(y);
+			for (int i = 0; i < words; ++i) {
+				auto spread = row[i] | (row[i] << 1) | (row[i] >> 1);
+				if (i > 0)
+					spread |= row[i - 1] >> 63;
+				if (i + 1 < words)
+					spread |= row[i + 1] << 63;
+				if (y > 0)
+					spread |= from.line(y - 1)[i];
+				if (y + 1 < height)
+					spread |= from.line(y + 1)[i];
+				to_row[i] = spread & ~covered_row[i];
+			}
+			to_row[words - 1] &= last_word_mask;
+		}
+	}
+};
+
+struct Solution {
+	static Blizzard parse(Input_Source &input) {
+		return read_input(input);
+	}
+
+	static int part1(const Blizzard &blizzard) {
+		const std::array trip{Position{0, -1}, blizzard.determine_goal()};
+		return Trip_Planner{blizzard}.arrival_times(trip).back();
+	}
+
+	static int part2(const Blizzard &blizzard) {
+		return both(blizzard).second;
+	}
+
+	/*
+	 * The trip there is part 1's answer and the first leg of part 2.
+	 */
+	static std::pair<int, int> both(const Blizzard &blizzard) {
+		const Position start{0, -1};
+		const auto goal = blizzard.determine_goal();
+		const std::array trip{start, goal, start, goal};
+		const auto arrivals = Trip_Planner{blizzard}.arrival_times(trip);
+		return std::make_pair(arrivals.front(), arrivals.back());
+	}
+};
+
 }
+
+AOC_SOLUTION(24, Solution)
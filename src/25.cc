@@ -3,6 +3,8 @@
 #include <numeric>
 #include <ranges>
 
+namespace {
+
 static long snafu_value(char snafu_char) noexcept {
 	switch (snafu_char) {
 	case '=': return -2;
@@ -19,7 +21,7 @@ static char snafu_char(long snafu_value) noexcept {
 	}
 }
 
-static long to_decimal(const std::string &snafu) noexcept {
+static long to_decimal(std::string_view snafu) noexcept {
 	long decimal{0};
 	long base = 1;
 	for (auto it = snafu.rbegin(); it != snafu.rend(); ++it) {
@@ -63,21 +65,22 @@ static std::string to_snafu(long decimal) {
 	return snafu;
 }
 
-static std::string snafu_sum(const std::vector<std::string> &snafu_nums) {
+static std::string snafu_sum(const std::vector<std::string_view> &snafu_nums) {
 	std::vector<long> decimal_nums(snafu_nums.size());
 	std::ranges::transform(snafu_nums, decimal_nums.begin(), [](const auto &snafu) { return to_decimal(snafu); });
 	return to_snafu(std::reduce(decimal_nums.begin(), decimal_nums.end()));
 }
 
-int main(int argc, char *argv[]) {
-	const auto part = select_part(argc, argv);
-	const auto snafu_nums = read_lines(std::cin);
-	switch (part) {
-	case 1:
-		std::cout << snafu_sum(snafu_nums) << std::endl;
-		break;
-	case 2:
-		break;
+struct Solution {
+	static std::vector<std::string_view> parse(Input_Source &input) {
+		return read_lines(input);
+	}
+
+	static std::string part1(const std::vector<std::string_view> &snafu_nums) {
+		return snafu_sum(snafu_nums);
 	}
-	return 0;
+};
+
 }
+
+AOC_SOLUTION(25, Solution)
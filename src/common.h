@@ -1,127 +1,285 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <filesystem>
 #include <functional>
+#include <future>
+#include <initializer_list>
+#include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <sstream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* --- Input source --- */
+
+/*
+ * Holds the entire input in one contiguous buffer and hands out views into it. Regular files are memory-mapped;
+ * anything else (pipes, terminals) is slurped into a single heap buffer. Views returned by the readers below
+ * remain valid for the lifetime of the Input_Source. Blank lines at the end of the input are left out, so a file saved
+ * with an extra newline reads the same as one without.
+ */
+struct Input_Source {
+	explicit Input_Source(int fd = STDIN_FILENO) {
+		load(fd);
+	}
+
+	explicit Input_Source(const std::string &path) {
+		const auto fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::system_error{errno, std::generic_category(), "Failed to open " + path};
+		try {
+			load(fd);
+		} catch (...) {
+			::close(fd);
+			throw;
+		}
+		::close(fd);
+	}
+
+	Input_Source(const Input_Source &) = delete;
+
+	Input_Source(Input_Source &&other) noexcept
+		: buffer_{std::move(other.buffer_)},
+		  data_{std::exchange(other.data_, std::string_view{})},
+		  pos_{std::exchange(other.pos_, 0)},
+		  mapped_size_{std::exchange(other.mapped_size_, 0)} { }
+
+	Input_Source &operator=(const Input_Source &) = delete;
+
+	Input_Source &operator=(Input_Source &&other) noexcept {
+		if (this != &other) {
+			unmap();
+			buffer_ = std::move(other.buffer_);
+			data_ = std::exchange(other.data_, std::string_view{});
+			pos_ = std::exchange(other.pos_, 0);
+			mapped_size_ = std::exchange(other.mapped_size_, 0);
+		}
+		return *this;
+	}
+
+	~Input_Source() {
+		unmap();
+	}
+
+	[[nodiscard]] bool empty() const noexcept {
+		return pos_ >= data_.size();
+	}
+
+	[[nodiscard]] std::string_view remaining() const noexcept {
+		return data_.substr(std::min(pos_, data_.size()));
+	}
+
+	std::string_view next_line() noexcept {
+		const auto rest = remaining();
+		const auto line_end = rest.find('\n');
+		if (line_end == std::string_view::npos) {
+			pos_ = data_.size();
+			return rest;
+		}
+		pos_ += line_end + 1;
+		return rest.substr(0, line_end);
+	}
+
+private:
+	static constexpr std::size_t READ_CHUNK{1 << 16};
+
+	std::vector<char> buffer_;
+	std::string_view data_;
+	std::size_t pos_{0};
+	// Zero unless data_ lies in a mapping of this many bytes
+	std::size_t mapped_size_{0};
+
+	void load(int fd) {
+		read_all(fd);
+		while (data_.ends_with("\n\n"))
+			data_.remove_suffix(1);
+	}
+
+	void read_all(int fd) {
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+			const auto size = static_cast<std::size_t>(file_stat.st_size);
+			if (auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); addr != MAP_FAILED) {
+				madvise(addr, size, MADV_SEQUENTIAL);
+				mapped_size_ = size;
+				data_ = std::string_view{static_cast<const char *>(addr), size};
+				const auto offset = lseek(fd, 0, SEEK_CUR);
+				pos_ = offset > 0 ? std::min(static_cast<std::size_t>(offset), size) : 0;
+				return;
+			}
+		}
+		slurp(fd);
+	}
+
+	void slurp(int fd) {
+		std::size_t size{0};
+		for (;;) {
+			if (buffer_.size() - size < READ_CHUNK)
+				buffer_.resize(std::max(buffer_.size() * 2, size + READ_CHUNK));
+			const auto count = ::read(fd, buffer_.data() + size, buffer_.size() - size);
+			if (count == 0)
+				break;
+			if (count < 0) {
+				if (errno == EINTR)
+					continue;
+				throw std::system_error{errno, std::generic_category(), "Failed to read input"};
+			}
+			size += count;
+		}
+		buffer_.resize(size);
+		data_ = std::string_view{buffer_.data(), buffer_.size()};
+	}
+
+	void unmap() noexcept {
+		if (mapped_size_ > 0)
+			munmap(const_cast<char *>(data_.data()), mapped_size_);
+		mapped_size_ = 0;
+	}
+};
 
 /* --- Input readers --- */
 
-bool has_input(std::istream &in) {
-	return in.peek() != -1;
+template<typename T = int>
+[[nodiscard]] T parse_number(std::string_view str) {
+	T value{};
+	if (const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value); ec != std::errc{})
+		throw std::invalid_argument{std::string{"Not a number: "} + std::string{str}};
+	return value;
 }
 
-std::string read_line(std::istream &in) {
-	std::string line;
-	std::getline(in, line);
-	return line;
+template<typename Token_FuncT>
+void for_each_token(std::string_view line, char delim, const Token_FuncT &token_func) {
+	for (std::size_t pos = 0; pos < line.size(); ) {
+		const auto token_end = std::min(line.find(delim, pos), line.size());
+		token_func(line.substr(pos, token_end - pos));
+		pos = token_end + 1;
+	}
 }
 
-std::vector<std::string> read_lines(std::istream &in) {
-	std::vector<std::string> lines;
-	for (std::string line; std::getline(in, line); )
-		lines.push_back(std::move(line));
-	return lines;
+inline bool has_input(const Input_Source &in) {
+	return !in.empty();
 }
 
-std::vector<std::string> read_tokens(const std::string &line, char delim = ' ') {
-	std::vector<std::string> tokens;
-	std::stringstream ss{line};
-	for (std::string token; std::getline(ss, token, delim); )
-		tokens.push_back(token);
-	return tokens;
+inline std::string_view read_line(Input_Source &in) {
+	return in.next_line();
 }
 
-template<typename Transform_FuncT = std::function<char(char)>>
-auto read_grid(std::istream &in, const Transform_FuncT &transform_func = [](char c) { return c; }) {
-	using Element_Type = std::decay_t<std::invoke_result_t<decltype(transform_func), char>>;
-	std::vector<std::vector<Element_Type>> grid;
-	for (std::string line; std::getline(in, line) && !line.empty(); ) {
-		std::vector<Element_Type> grid_line(line.size());
-		std::transform(line.begin(), line.end(), grid_line.begin(), transform_func);
-		grid.push_back(std::move(grid_line));
-	}
-	return grid;
+inline std::vector<std::string_view> read_lines(Input_Source &in) {
+	std::vector<std::string_view> lines;
+	while (has_input(in))
+		lines.push_back(read_line(in));
+	return lines;
 }
 
-std::vector<std::vector<int>> read_integer_grid(std::istream &in) {
-	return read_grid(in, [](char c) { return c - '0'; });
+inline std::vector<std::string_view> read_tokens(std::string_view line, char delim = ' ') {
+	std::vector<std::string_view> tokens;
+	for_each_token(line, delim, [&tokens](auto token) { tokens.push_back(token); });
+	return tokens;
 }
 
+/*
+ * The readers below dispatch statically to the CRTP type, which implements read_token()/read_line() and optionally
+ * read_end(). The token or line index is passed in rather than stored, so parsed records carry no reader state.
+ */
+
 template<class CRTP, char DelimV = ' '>
 struct Token_Reader {
-	static CRTP create_from_stream(std::istream &in) {
-		std::string line;
-		if (!std::getline(in, line))
+	static CRTP create_from_input(Input_Source &in) {
+		if (!has_input(in))
 			throw std::logic_error{"EOF encountered in Token_Reader"};
-		std::istringstream ss{line};
 
 		CRTP instance{};
-		for (std::string token; std::getline(ss, token, DelimV); ++instance.token_num_)
-			instance.read_token(token);
+		std::size_t token_num{0};
+		for_each_token(read_line(in), DelimV, [&instance, &token_num](auto token) {
+			instance.read_token(token_num++, token);
+		});
 		instance.read_end();
 		return instance;
 	}
 
-	virtual ~Token_Reader() = default;
-
-	virtual void read_token(const std::string &token) = 0;
-
-	virtual void read_end() { };
-
-	[[nodiscard]] std::size_t token_num() const noexcept {
-		return token_num_;
-	}
-
-private:
-	std::size_t token_num_{0};
+	void read_end() noexcept { }
 };
 
 template<class CRTP>
 struct Line_Reader {
-	static CRTP create_from_stream(std::istream &in) {
-		std::string line;
-		if (!std::getline(in, line))
+	static CRTP create_from_input(Input_Source &in) {
+		if (!has_input(in))
 			throw std::logic_error{"EOF encountered in Line_Reader"};
 
 		CRTP instance{};
-		instance.read_line(line);
+		instance.read_line(in.next_line());
 		return instance;
 	}
-
-	virtual ~Line_Reader() = default;
-
-	virtual void read_line(const std::string &line) = 0;
 };
 
 template<class CRTP>
 struct Paragraph_Reader {
-	static CRTP create_from_stream(std::istream &in) {
+	static CRTP create_from_input(Input_Source &in) {
 		CRTP instance{};
-		for (std::string line; std::getline(in, line) && !line.empty(); ++instance.line_num_)
-			instance.read_line(line);
+		std::size_t line_num{0};
+		for (std::string_view line; has_input(in) && !(line = in.next_line()).empty(); ++line_num)
+			instance.read_line(line_num, line);
 		instance.read_end();
 		return instance;
 	}
 
-	virtual ~Paragraph_Reader() = default;
+	void read_end() noexcept { }
+};
+
+template<class RecordT>
+[[nodiscard]] std::vector<RecordT> read_records(Input_Source &in) {
+	std::vector<RecordT> records;
+	while (has_input(in))
+		records.push_back(RecordT::create_from_input(in));
+	return records;
+}
 
-	virtual void read_line(const std::string &line) = 0;
+/* --- Hashing --- */
 
-	virtual void read_end() { };
+/*
+ * Finalizer from splitmix64: spreads every input bit across the whole word, so keys packed from small coordinates
+ * still land in distinct buckets of power-of-two sized tables.
+ */
+[[nodiscard]] constexpr std::uint64_t mix_hash(std::uint64_t key) noexcept {
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111eb;
+	key ^= key >> 31;
+	return key;
+}
 
-	[[nodiscard]] std::size_t line_num() const noexcept {
-		return line_num_;
-	}
+[[nodiscard]] constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) noexcept {
+	return mix_hash(seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2)));
+}
 
-private:
-	std::size_t line_num_{0};
-};
+[[nodiscard]] constexpr std::uint64_t pack_key(std::int32_t hi, std::int32_t lo) noexcept {
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(hi)) << 32) | static_cast<std::uint32_t>(lo);
+}
 
 /* --- Position --- */
 
@@ -150,40 +308,466 @@ namespace std {
 	template<>
 	struct hash<Position> {
 		[[nodiscard]] std::size_t operator()(const Position &position) const noexcept {
-			return (static_cast<std::size_t>(position.x) << 32) + static_cast<std::size_t>(position.y);
+			return mix_hash(pack_key(position.x, position.y));
 		}
 	};
 
 	template<>
 	struct hash<Position3D> {
 		[[nodiscard]] std::size_t operator()(const Position3D &position) const noexcept {
-			return std::hash<std::string>{}(std::to_string(position.x) + "," + std::to_string(position.y) + "," + std::to_string(position.z));
+			return hash_combine(pack_key(position.x, position.y), static_cast<std::uint32_t>(position.z));
 		}
 	};
 
 	template<>
 	struct hash<Grid_Position> {
 		[[nodiscard]] std::size_t operator()(const Grid_Position &position) const noexcept {
-			return (position.r << 32) + static_cast<std::size_t>(position.c);
+			return mix_hash((static_cast<std::uint64_t>(position.r) << 32) ^ position.c);
 		}
 	};
 
-	std::ostream &operator<<(std::ostream &out, const Position &position) {
+	inline std::ostream &operator<<(std::ostream &out, const Position &position) {
 		out << "<" << position.x << "," << position.y << ">";
 		return out;
 	}
 
-	std::ostream &operator<<(std::ostream &out, const Position3D &position) {
+	inline std::ostream &operator<<(std::ostream &out, const Position3D &position) {
 		out << "<" << position.x << "," << position.y << "," << position.z << ">";
 		return out;
 	}
 
-	std::ostream &operator<<(std::ostream &out, const Grid_Position &position) {
+	inline std::ostream &operator<<(std::ostream &out, const Grid_Position &position) {
 		out << "<" << position.r << "," << position.c << ">";
 		return out;
 	}
 }
 
+/* --- Flat hash tables --- */
+
+template<typename SlotT>
+struct Flat_Hash_Iterator {
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_const_t<SlotT>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = SlotT *;
+	using reference = SlotT &;
+
+	Flat_Hash_Iterator() = default;
+
+	Flat_Hash_Iterator(SlotT *slot, SlotT *end, const std::uint8_t *used) noexcept
+		: slot_{slot},
+		  end_{end},
+		  used_{used} {
+		skip_empty();
+	}
+
+	[[nodiscard]] reference operator*() const noexcept {
+		return *slot_;
+	}
+
+	[[nodiscard]] pointer operator->() const noexcept {
+		return slot_;
+	}
+
+	Flat_Hash_Iterator &operator++() noexcept {
+		++slot_;
+		++used_;
+		skip_empty();
+		return *this;
+	}
+
+	Flat_Hash_Iterator operator++(int) noexcept {
+		auto prev = *this;
+		++*this;
+		return prev;
+	}
+
+	[[nodiscard]] bool operator==(const Flat_Hash_Iterator &other) const noexcept {
+		return slot_ == other.slot_;
+	}
+
+private:
+	SlotT *slot_{nullptr}, *end_{nullptr};
+	const std::uint8_t *used_{nullptr};
+
+	void skip_empty() noexcept {
+		while (slot_ != end_ && !*used_) {
+			++slot_;
+			++used_;
+		}
+	}
+};
+
+/*
+ * Open-addressing hash table with linear probing over a power-of-two slot array that is kept at most half full.
+ * Erasure shifts later entries of the probe run back instead of leaving tombstones. As with std::vector, insertion
+ * and erasure invalidate iterators and references.
+ */
+template<typename KeyT, typename SlotT, typename HashT, typename KeyOfT>
+struct Flat_Hash_Table {
+	using key_type = KeyT;
+	using value_type = SlotT;
+	using size_type = std::size_t;
+	using iterator = Flat_Hash_Iterator<SlotT>;
+	using const_iterator = Flat_Hash_Iterator<const SlotT>;
+
+	Flat_Hash_Table() = default;
+
+	explicit Flat_Hash_Table(std::size_t expected_size) {
+		reserve(expected_size);
+	}
+
+	template<typename InputIt>
+	Flat_Hash_Table(InputIt first, InputIt last) {
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+			reserve(std::distance(first, last));
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	Flat_Hash_Table(std::initializer_list<SlotT> slots)
+		: Flat_Hash_Table(slots.begin(), slots.end()) { }
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return size_;
+	}
+
+	[[nodiscard]] bool empty() const noexcept {
+		return size_ == 0;
+	}
+
+	[[nodiscard]] iterator begin() noexcept {
+		return iterator{slots_.data(), slots_.data() + slots_.size(), used_.data()};
+	}
+
+	[[nodiscard]] iterator end() noexcept {
+		return iterator{slots_.data() + slots_.size(), slots_.data() + slots_.size(), used_.data() + used_.size()};
+	}
+
+	[[nodiscard]] const_iterator begin() const noexcept {
+		return const_iterator{slots_.data(), slots_.data() + slots_.size(), used_.data()};
+	}
+
+	[[nodiscard]] const_iterator end() const noexcept {
+		return const_iterator{slots_.data() + slots_.size(), slots_.data() + slots_.size(), used_.data() + used_.size()};
+	}
+
+	void clear() noexcept {
+		std::fill(used_.begin(), used_.end(), 0);
+		size_ = 0;
+	}
+
+	void reserve(std::size_t count) {
+		auto capacity = MIN_CAPACITY;
+		while (capacity < count * 2)
+			capacity *= 2;
+		if (capacity > slots_.size())
+			rehash(capacity);
+	}
+
+	[[nodiscard]] bool contains(const KeyT &key) const noexcept {
+		return find_index(key) != NPOS;
+	}
+
+	[[nodiscard]] iterator find(const KeyT &key) noexcept {
+		const auto idx = find_index(key);
+		return idx == NPOS ? end() : iterator_at(idx);
+	}
+
+	[[nodiscard]] const_iterator find(const KeyT &key) const noexcept {
+		const auto idx = find_index(key);
+		return idx == NPOS ? end() : const_iterator{slots_.data() + idx, slots_.data() + slots_.size(), used_.data() + idx};
+	}
+
+	/*
+	 * Grows only when the key is new, so inserting a key already present never moves the slots.
+	 */
+	std::pair<iterator, bool> insert(const SlotT &slot) {
+		if ((size_ + 1) * 2 > slots_.size()) {
+			if (const auto idx = find_index(KeyOfT{}(slot)); idx != NPOS)
+				return std::make_pair(iterator_at(idx), false);
+			rehash(std::max(MIN_CAPACITY, slots_.size() * 2));
+		}
+		const auto idx = probe(KeyOfT{}(slot));
+		if (used_[idx])
+			return std::make_pair(iterator_at(idx), false);
+		slots_[idx] = slot;
+		used_[idx] = true;
+		++size_;
+		return std::make_pair(iterator_at(idx), true);
+	}
+
+	std::size_t erase(const KeyT &key) noexcept {
+		auto hole = find_index(key);
+		if (hole == NPOS)
+			return 0;
+		for (auto idx = (hole + 1) & mask_; used_[idx]; idx = (idx + 1) & mask_) {
+			const auto home = HashT{}(KeyOfT{}(slots_[idx])) & mask_;
+			if (((idx - home) & mask_) >= ((idx - hole) & mask_)) {
+				slots_[hole] = std::move(slots_[idx]);
+				hole = idx;
+			}
+		}
+		used_[hole] = false;
+		--size_;
+		return 1;
+	}
+
+protected:
+	[[nodiscard]] iterator iterator_at(std::size_t idx) noexcept {
+		return iterator{slots_.data() + idx, slots_.data() + slots_.size(), used_.data() + idx};
+	}
+
+private:
+	static constexpr std::size_t MIN_CAPACITY{16};
+	static constexpr std::size_t NPOS{static_cast<std::size_t>(-1)};
+
+	std::vector<SlotT> slots_;
+	std::vector<std::uint8_t> used_;
+	std::size_t size_{0};
+	std::size_t mask_{0};
+
+	[[nodiscard]] std::size_t probe(const KeyT &key) const noexcept {
+		auto idx = HashT{}(key) & mask_;
+		while (used_[idx] && !(KeyOfT{}(slots_[idx]) == key))
+			idx = (idx + 1) & mask_;
+		return idx;
+	}
+
+	[[nodiscard]] std::size_t find_index(const KeyT &key) const noexcept {
+		if (size_ == 0)
+			return NPOS;
+		const auto idx = probe(key);
+		return used_[idx] ? idx : NPOS;
+	}
+
+	void rehash(std::size_t capacity) {
+		auto old_slots = std::exchange(slots_, std::vector<SlotT>(capacity));
+		auto old_used = std::exchange(used_, std::vector<std::uint8_t>(capacity, false));
+		mask_ = capacity - 1;
+		for (std::size_t idx = 0; idx < old_slots.size(); ++idx) {
+			if (old_used[idx]) {
+				const auto new_idx = probe(KeyOfT{}(old_slots[idx]));
+				slots_[new_idx] = std::move(old_slots[idx]);
+				used_[new_idx] = true;
+			}
+		}
+	}
+};
+
+struct Set_Key_Of {
+	template<typename KeyT>
+	[[nodiscard]] const KeyT &operator()(const KeyT &key) const noexcept {
+		return key;
+	}
+};
+
+struct Map_Key_Of {
+	template<typename PairT>
+	[[nodiscard]] const auto &operator()(const PairT &pair) const noexcept {
+		return pair.first;
+	}
+};
+
+template<typename KeyT, typename HashT = std::hash<KeyT>>
+struct Flat_Hash_Set : Flat_Hash_Table<KeyT, KeyT, HashT, Set_Key_Of> {
+	using Flat_Hash_Table<KeyT, KeyT, HashT, Set_Key_Of>::Flat_Hash_Table;
+};
+
+template<typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+struct Flat_Hash_Map : Flat_Hash_Table<KeyT, std::pair<KeyT, ValueT>, HashT, Map_Key_Of> {
+	using Flat_Hash_Table<KeyT, std::pair<KeyT, ValueT>, HashT, Map_Key_Of>::Flat_Hash_Table;
+
+	ValueT &operator[](const KeyT &key) {
+		if (auto it = this->find(key); it != this->end())
+			return it->second;
+		return this->insert(std::make_pair(key, ValueT{})).first->second;
+	}
+};
+
+using Position_Set = Flat_Hash_Set<Position>;
+
+template<typename ValueT>
+using Position_Map = Flat_Hash_Map<Position, ValueT>;
+
+struct Mixed_Key_Hash {
+	[[nodiscard]] std::size_t operator()(std::uint64_t key) const noexcept {
+		return mix_hash(key);
+	}
+};
+
+/*
+ * Direct-mapped cache from packed keys: every key has one slot, chosen by its hash, and a new key simply
+ * replaces whatever was there. Memory is fixed by the budget given up front however many keys pass through, at the
+ * cost of forgetting entries, which suits memo and dominance tables that only lose pruning power on a miss. Slots are
+ * stamped with an epoch, so clear() is constant time until the epoch counter wraps.
+ */
+template<typename ValueT, typename KeyT = std::uint64_t, typename HashT = Mixed_Key_Hash>
+struct Capped_Cache {
+	explicit Capped_Cache(std::size_t max_bytes) {
+		std::size_t capacity{1};
+		while (capacity * 2 * sizeof(Slot) <= max_bytes)
+			capacity *= 2;
+		slots_.resize(capacity);
+		mask_ = capacity - 1;
+	}
+
+	[[nodiscard]] std::size_t capacity() const noexcept {
+		return slots_.size();
+	}
+
+	[[nodiscard]] ValueT *find(const KeyT &key) noexcept {
+		auto &slot = slots_[HashT{}(key) & mask_];
+		return slot.epoch == epoch_ && slot.key == key ? &slot.value : nullptr;
+	}
+
+	void insert(const KeyT &key, ValueT value) noexcept {
+		slots_[HashT{}(key) & mask_] = Slot{key, std::move(value), epoch_};
+	}
+
+	void clear() noexcept {
+		if (++epoch_ == 0) {
+			std::fill(slots_.begin(), slots_.end(), Slot{});
+			epoch_ = 1;
+		}
+	}
+
+private:
+	struct Slot {
+		KeyT key{};
+		ValueT value{};
+		std::uint32_t epoch{0};
+	};
+
+	std::vector<Slot> slots_;
+	std::size_t mask_{0};
+	std::uint32_t epoch_{1};
+};
+
+/* --- Grid --- */
+
+/*
+ * Row-major grid held in one contiguous allocation. An optional border of padding() cells on every side holds a
+ * sentinel value, so neighbour steps through flat indices (+/-1, +/-stride()) need no bounds checks near the edge.
+ * Row/column coordinates and Grid_Positions address the interior; flat indices address cells().
+ */
+template<typename T>
+struct Grid {
+	static_assert(!std::is_same_v<T, bool>, "Use std::uint8_t instead of bool for Grid cells");
+
+	Grid() = default;
+
+	Grid(std::size_t height, std::size_t width, const T &value = T{}, std::size_t padding = 0)
+		: Grid{height, width, value, padding, value} { }
+
+	Grid(std::size_t height, std::size_t width, const T &value, std::size_t padding, const T &border)
+		: height_{height},
+		  width_{width},
+		  padding_{padding},
+		  stride_{width + 2 * padding},
+		  cells_((height + 2 * padding) * stride_, border) {
+		if (padding_ > 0) {
+			for (std::size_t r = 0; r < height_; ++r)
+				std::fill_n(cells_.begin() + index(r, 0), width_, value);
+		} else {
+			std::fill(cells_.begin(), cells_.end(), value);
+		}
+	}
+
+	[[nodiscard]] std::size_t height() const noexcept {
+		return height_;
+	}
+
+	[[nodiscard]] std::size_t width() const noexcept {
+		return width_;
+	}
+
+	[[nodiscard]] std::size_t padding() const noexcept {
+		return padding_;
+	}
+
+	[[nodiscard]] std::size_t stride() const noexcept {
+		return stride_;
+	}
+
+	[[nodiscard]] bool in_bounds(const Grid_Position &position) const noexcept {
+		return position.r < height_ && position.c < width_;
+	}
+
+	[[nodiscard]] std::size_t index(std::size_t r, std::size_t c) const noexcept {
+		return (r + padding_) * stride_ + c + padding_;
+	}
+
+	[[nodiscard]] std::size_t index(const Grid_Position &position) const noexcept {
+		return index(position.r, position.c);
+	}
+
+	[[nodiscard]] Grid_Position position(std::size_t index) const noexcept {
+		return Grid_Position{index / stride_ - padding_, index % stride_ - padding_};
+	}
+
+	[[nodiscard]] T &operator()(std::size_t r, std::size_t c) noexcept {
+		return cells_[index(r, c)];
+	}
+
+	[[nodiscard]] const T &operator()(std::size_t r, std::size_t c) const noexcept {
+		return cells_[index(r, c)];
+	}
+
+	[[nodiscard]] T &operator[](const Grid_Position &position) noexcept {
+		return cells_[index(position)];
+	}
+
+	[[nodiscard]] const T &operator[](const Grid_Position &position) const noexcept {
+		return cells_[index(position)];
+	}
+
+	[[nodiscard]] std::span<T> row(std::size_t r) noexcept {
+		return std::span<T>{cells_.data() + index(r, 0), width_};
+	}
+
+	[[nodiscard]] std::span<const T> row(std::size_t r) const noexcept {
+		return std::span<const T>{cells_.data() + index(r, 0), width_};
+	}
+
+	[[nodiscard]] std::span<T> cells() noexcept {
+		return std::span<T>{cells_};
+	}
+
+	[[nodiscard]] std::span<const T> cells() const noexcept {
+		return std::span<const T>{cells_};
+	}
+
+private:
+	std::size_t height_{0}, width_{0}, padding_{0}, stride_{0};
+	std::vector<T> cells_;
+};
+
+/*
+ * Reads lines up to the next blank line into a grid. Rows shorter than the widest one, and the optional border, are
+ * filled with transform_func(fill_char).
+ */
+template<typename Transform_FuncT = std::function<char(char)>>
+auto read_grid(Input_Source &in, const Transform_FuncT &transform_func = [](char c) { return c; },
+			   std::size_t padding = 0, char fill_char = ' ') {
+	using Element_Type = std::decay_t<std::invoke_result_t<decltype(transform_func), char>>;
+	std::vector<std::string_view> lines;
+	for (std::string_view line; has_input(in) && !(line = read_line(in)).empty(); )
+		lines.push_back(line);
+
+	std::size_t width{0};
+	for (auto line : lines)
+		width = std::max(width, line.size());
+	Grid<Element_Type> grid{lines.size(), width, transform_func(fill_char), padding};
+	for (std::size_t r = 0; r < lines.size(); ++r)
+		std::transform(lines[r].begin(), lines[r].end(), grid.row(r).begin(), transform_func);
+	return grid;
+}
+
+inline Grid<int> read_integer_grid(Input_Source &in) {
+	return read_grid(in, [](char c) { return c - '0'; });
+}
+
 /* --- Circular Queue --- */
 
 template<typename T, typename QueueT = std::vector<T>>
@@ -231,8 +815,9 @@ private:
 /* --- Visual debugging */
 
 template<typename ItemT>
-void print_grid(const std::vector<std::vector<ItemT>> &grid) {
-	for (const auto &row : grid) {
+void print_grid(const Grid<ItemT> &grid) {
+	for (std::size_t r = 0; r < grid.height(); ++r) {
+		const auto row = grid.row(r);
 		std::copy(row.begin(), row.end(), std::ostream_iterator<ItemT>(std::cout));
 		std::cout << std::endl;
 	}
@@ -254,29 +839,551 @@ void print_grid_positions(const PositionsT &positions, char display_char = '#')
 
 template<typename PositionsT>
 void print_grid_positions(const PositionsT &positions, std::size_t min_x, std::size_t min_y, std::size_t max_x, std::size_t max_y, char display_char = '#') {
-	std::vector<std::vector<char>> grid(max_y - min_y + 1, std::vector<char>(max_x - min_x + 1, '.'));
+	Grid<char> grid{max_y - min_y + 1, max_x - min_x + 1, '.'};
 	for (const auto &position : positions)
-		grid[position.y - min_y][position.x - min_x] = display_char;
-	for (const auto &row : grid) {
-		std::copy(row.begin(), row.end(), std::ostream_iterator<char>(std::cout));
-		std::cout << std::endl;
+		grid(position.y - min_y, position.x - min_x) = display_char;
+	print_grid(grid);
+}
+
+/* --- Thread pool --- */
+
+/*
+ * Caps default_thread_count() on the calling thread while in scope. Solves run as tasks of an outer pool (the
+ * multi-day runner, batch mode) set one so that the pools their solvers start share the outer pool's threads
+ * instead of each taking a full set.
+ */
+struct Thread_Budget {
+	explicit Thread_Budget(std::size_t num_threads)
+		: previous_{limit()} {
+		limit() = std::max<std::size_t>(num_threads, 1);
+	}
+
+	Thread_Budget(const Thread_Budget &) = delete;
+	Thread_Budget &operator=(const Thread_Budget &) = delete;
+
+	~Thread_Budget() {
+		limit() = previous_;
+	}
+
+	// Zero when no budget is in force
+	[[nodiscard]] static std::size_t &limit() noexcept {
+		static thread_local std::size_t limit{0};
+		return limit;
+	}
+
+private:
+	std::size_t previous_;
+};
+
+/*
+ * Number of workers to use when none is given explicitly: the calling thread's Thread_Budget if one is in force,
+ * otherwise $AOC_THREADS if set, otherwise one per hardware thread.
+ */
+[[nodiscard]] inline std::size_t default_thread_count() {
+	if (const auto budget = Thread_Budget::limit(); budget > 0)
+		return budget;
+	if (const auto env = std::getenv("AOC_THREADS"); env != nullptr && *env != '\0')
+		return std::max<std::size_t>(parse_number<std::size_t>(env), 1);
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/*
+ * Work-stealing thread pool. Every worker owns a deque of tasks: tasks submitted from a worker go to the back of its
+ * own deque and are popped from there, while idle workers steal from the front of the other deques. Tasks submitted
+ * from outside the pool are dealt out round-robin. Threads that need to wait on a task's result should use
+ * wait_for() so they keep running pending tasks instead of blocking a worker.
+ */
+struct Thread_Pool {
+	explicit Thread_Pool(std::size_t num_threads = default_thread_count())
+		: queues_(std::max<std::size_t>(num_threads, 1)) {
+		workers_.reserve(queues_.size());
+		for (std::size_t i = 0; i < queues_.size(); ++i)
+			workers_.emplace_back([this, i] { work(i); });
+	}
+
+	Thread_Pool(const Thread_Pool &) = delete;
+	Thread_Pool &operator=(const Thread_Pool &) = delete;
+
+	~Thread_Pool() {
+		{
+			std::lock_guard lock{mutex_};
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		for (auto &worker : workers_)
+			worker.join();
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return workers_.size();
+	}
+
+	template<typename FuncT>
+	[[nodiscard]] std::future<std::invoke_result_t<FuncT &>> submit(FuncT func) {
+		using Result_Type = std::invoke_result_t<FuncT &>;
+		auto task = std::make_shared<std::packaged_task<Result_Type()>>(std::move(func));
+		auto future = task->get_future();
+		push([task] { (*task)(); });
+		return future;
+	}
+
+	/*
+	 * Run one pending task on the calling thread, if there is one.
+	 */
+	bool run_pending_task() {
+		if (auto task = pop(current_pool_ == this ? current_index_ : 0)) {
+			task();
+			return true;
+		}
+		return false;
+	}
+
+	template<typename T>
+	T wait_for(std::future<T> &future) {
+		while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+			if (!run_pending_task())
+				std::this_thread::yield();
+		}
+		return future.get();
+	}
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	static inline thread_local const Thread_Pool *current_pool_{nullptr};
+	static inline thread_local std::size_t current_index_{0};
+
+	std::vector<Queue> queues_;
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::atomic<std::size_t> num_pending_{0};
+	std::atomic<std::size_t> next_queue_{0};
+	bool stopping_{false};
+
+	void push(std::function<void()> task) {
+		const auto index = current_pool_ == this ? current_index_ : next_queue_++ % queues_.size();
+		{
+			std::lock_guard lock{queues_[index].mutex};
+			queues_[index].tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard lock{mutex_};
+			++num_pending_;
+		}
+		wake_.notify_one();
+	}
+
+	std::function<void()> pop(std::size_t index) {
+		for (std::size_t offset = 0; offset < queues_.size(); ++offset) {
+			auto &queue = queues_[(index + offset) % queues_.size()];
+			std::lock_guard lock{queue.mutex};
+			if (queue.tasks.empty())
+				continue;
+			std::function<void()> task;
+			if (offset == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			} else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			--num_pending_;
+			return task;
+		}
+		return {};
+	}
+
+	void work(std::size_t index) {
+		current_pool_ = this;
+		current_index_ = index;
+		for (;;) {
+			if (auto task = pop(index)) {
+				task();
+				continue;
+			}
+			std::unique_lock lock{mutex_};
+			wake_.wait(lock, [this] { return stopping_ || num_pending_ > 0; });
+			if (stopping_ && num_pending_ == 0)
+				return;
+		}
 	}
+};
+
+/* --- Instrumentation --- */
+
+/*
+ * Scoped timers, counters and high-water gauges for looking inside a solve. AOC_TIMER, AOC_COUNT and AOC_GAUGE compile
+ * to nothing (their arguments are not evaluated) unless built with AOC_STATS, i.e. make STATS=1. A stats build prints
+ * everything collected to stderr when run with --stats or with $AOC_STATS set.
+ */
+
+[[nodiscard]] inline bool &stats_requested() {
+	static bool requested{[] {
+		const auto env = std::getenv("AOC_STATS");
+		return env != nullptr && *env != '\0';
+	}()};
+	return requested;
+}
+
+#ifdef AOC_STATS
+
+enum class Stat_Kind { TIMER, COUNTER, GAUGE };
+
+struct Stat {
+	Stat(std::string_view name, Stat_Kind kind)
+		: name{name},
+		  kind{kind} { }
+
+	const std::string name;
+	const Stat_Kind kind;
+	std::atomic<std::uint64_t> value{0};
+	std::atomic<std::uint64_t> count{0};
+
+	void add(std::uint64_t amount) noexcept {
+		value.fetch_add(amount, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void raise(std::uint64_t level) noexcept {
+		auto current = value.load(std::memory_order_relaxed);
+		while (level > current && !value.compare_exchange_weak(current, level, std::memory_order_relaxed)) { }
+	}
+};
+
+struct Stats_Registry {
+	[[nodiscard]] static Stats_Registry &instance() {
+		static Stats_Registry registry;
+		return registry;
+	}
+
+	[[nodiscard]] Stat &get(std::string_view name, Stat_Kind kind) {
+		std::lock_guard lock{mutex_};
+		const auto it = std::find_if(stats_.begin(), stats_.end(), [name](const auto &stat) { return stat.name == name; });
+		return it != stats_.end() ? *it : stats_.emplace_back(name, kind);
+	}
+
+	void report(std::ostream &out) {
+		std::lock_guard lock{mutex_};
+		for (const auto &stat : stats_) {
+			out << std::left << std::setw(40) << stat.name << std::right << ' ';
+			switch (stat.kind) {
+			case Stat_Kind::TIMER:
+				out << std::fixed << std::setprecision(3) << stat.value / 1e6 << " ms (" << stat.count << " calls)";
+				break;
+			case Stat_Kind::COUNTER:
+				out << stat.value;
+				break;
+			case Stat_Kind::GAUGE:
+				out << stat.value << " (peak)";
+				break;
+			}
+			out << '\n';
+		}
+	}
+
+private:
+	std::mutex mutex_;
+	std::deque<Stat> stats_;
+};
+
+struct Scoped_Timer {
+	explicit Scoped_Timer(Stat &stat) noexcept
+		: stat_{stat},
+		  start_{std::chrono::steady_clock::now()} { }
+
+	Scoped_Timer(const Scoped_Timer &) = delete;
+	Scoped_Timer &operator=(const Scoped_Timer &) = delete;
+
+	~Scoped_Timer() {
+		stat_.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+	}
+
+private:
+	Stat &stat_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+#define AOC_STAT_CONCAT_(A, B) A##B
+#define AOC_STAT_CONCAT(A, B) AOC_STAT_CONCAT_(A, B)
+#define AOC_STAT(NAME, KIND) \
+	([]() -> Stat & { static auto &stat = Stats_Registry::instance().get(NAME, KIND); return stat; }())
+#define AOC_TIMER(NAME) Scoped_Timer AOC_STAT_CONCAT(aoc_timer_, __LINE__){AOC_STAT(NAME, Stat_Kind::TIMER)}
+#define AOC_COUNT(NAME, AMOUNT) AOC_STAT(NAME, Stat_Kind::COUNTER).add(AMOUNT)
+#define AOC_GAUGE(NAME, LEVEL) AOC_STAT(NAME, Stat_Kind::GAUGE).raise(LEVEL)
+
+#else
+
+#define AOC_TIMER(NAME) static_cast<void>(0)
+#define AOC_COUNT(NAME, AMOUNT) static_cast<void>(0)
+#define AOC_GAUGE(NAME, LEVEL) static_cast<void>(0)
+
+#endif
+
+inline void report_stats(std::ostream &out) {
+#ifdef AOC_STATS
+	Stats_Registry::instance().report(out);
+#else
+	out << "stats: not compiled in, rebuild with make STATS=1" << std::endl;
+#endif
 }
 
 /* --- Boilerplate --- */
 
-uint select_part(int argc, char *argv[]) {
-	if (argc < 2) {
-		std::cerr << "Usage: " << argv[0] << " <1|2>" << std::endl;
+/*
+ * Value of select_part() when both parts should be solved from a single parse.
+ */
+static constexpr uint BOTH_PARTS{3};
+
+/*
+ * Returns the part given on the command line: 1, 2 or BOTH_PARTS for "both". --stats may appear anywhere and
+ * requests the instrumentation report. Any further arguments are input files for batch mode (see batch_paths()).
+ */
+inline uint select_part(int argc, char *argv[]) {
+	const char *part_arg{nullptr};
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--stats") == 0)
+			stats_requested() = true;
+		else if (part_arg == nullptr)
+			part_arg = argv[i];
+	}
+
+	if (part_arg == nullptr) {
+		std::cerr << "Usage: " << argv[0] << " <1|2|both> [--stats] [FILE|DIR...]" << std::endl;
 		std::exit(1);
 	}
 
-	if (strncmp(argv[1], "1", 1) == 0) {
+	if (strcmp(part_arg, "both") == 0) {
+		return BOTH_PARTS;
+	} else if (strncmp(part_arg, "1", 1) == 0) {
 		return 1;
-	} else if (strncmp(argv[1], "2", 1) == 0) {
+	} else if (strncmp(part_arg, "2", 1) == 0) {
 		return 2;
 	} else {
-		std::cerr << argv[0] << ": invalid argument '" << argv[1] << "'" << std::endl;
+		std::cerr << argv[0] << ": invalid argument '" << part_arg << "'" << std::endl;
 		std::exit(1);
 	}
 }
+
+/*
+ * Returns the input files following the part on the command line, in order, with each directory replaced by the
+ * regular files it contains sorted by name. Empty when the input should be read from stdin.
+ */
+inline std::vector<std::string> batch_paths(int argc, char *argv[]) {
+	std::vector<std::string> paths;
+	bool part_seen{false};
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--stats") == 0)
+			continue;
+		if (!std::exchange(part_seen, true))
+			continue;
+		if (!std::filesystem::is_directory(argv[i])) {
+			paths.emplace_back(argv[i]);
+			continue;
+		}
+		const auto first = paths.size();
+		for (const auto &entry : std::filesystem::directory_iterator{argv[i]}) {
+			if (entry.is_regular_file())
+				paths.push_back(entry.path().string());
+		}
+		std::sort(paths.begin() + first, paths.end());
+	}
+	return paths;
+}
+
+/* --- Solutions --- */
+
+/*
+ * Every day defines a solution type providing
+ *
+ *   static State parse(Input_Source &input);
+ *   static Answer part1(State state);    // or const State &
+ *   static Answer part2(State state);    // optional
+ *
+ * where Answer is anything that can be written to an std::ostream. AOC_SOLUTION() either defines main() for the
+ * day's own binary or, when compiled with AOC_LIBRARY, registers the solution with the multi-day runner instead.
+ *
+ * When both parts are requested the input is parsed once. A solution whose parts share intermediate results provides
+ *
+ *   static std::pair<Answer1, Answer2> both(State state);
+ *
+ * Otherwise the two parts run on their own threads from the same state, each with half the thread budget, unless the
+ * solution declares INDEPENDENT_PARTS = false because its parts share mutable state, in which case they run one after
+ * the other.
+ */
+
+template<class SolutionT>
+concept Has_Part2 = requires(Input_Source &input) {
+	SolutionT::part2(SolutionT::parse(input));
+};
+
+template<class SolutionT>
+concept Has_Both = requires(Input_Source &input) {
+	SolutionT::both(SolutionT::parse(input));
+};
+
+template<class SolutionT>
+concept Independent_Parts = !requires { SolutionT::INDEPENDENT_PARTS; } || SolutionT::INDEPENDENT_PARTS;
+
+template<class SolutionT, class StateT>
+void solve_both(StateT &state, std::ostream &part1_out, std::ostream &part2_out) {
+	if constexpr (Has_Both<SolutionT>) {
+		const auto [answer1, answer2] = SolutionT::both(std::move(state));
+		part1_out << answer1 << '\n';
+		part2_out << answer2 << '\n';
+	} else if constexpr (!Has_Part2<SolutionT>) {
+		part1_out << SolutionT::part1(std::move(state)) << '\n';
+	} else if constexpr (Independent_Parts<SolutionT>) {
+		// Each part gets half the caller's threads; the part 2 thread would otherwise start without any budget
+		const auto threads_per_part = std::max<std::size_t>(default_thread_count() / 2, 1);
+		auto answer2 = std::async(std::launch::async, [&state, threads_per_part] {
+			Thread_Budget budget{threads_per_part};
+			return SolutionT::part2(std::as_const(state));
+		});
+		Thread_Budget budget{threads_per_part};
+		part1_out << SolutionT::part1(std::as_const(state)) << '\n';
+		part2_out << answer2.get() << '\n';
+	} else {
+		part1_out << SolutionT::part1(state) << '\n';
+		part2_out << SolutionT::part2(std::move(state)) << '\n';
+	}
+}
+
+template<class SolutionT>
+void solve_day(Input_Source &input, uint part, std::ostream &part1_out, std::ostream &part2_out) {
+	auto state = [&input] {
+		AOC_TIMER("parse");
+		return SolutionT::parse(input);
+	}();
+	AOC_TIMER("solve");
+	if (part == BOTH_PARTS) {
+		solve_both<SolutionT>(state, part1_out, part2_out);
+	} else if (part == 1) {
+		part1_out << SolutionT::part1(std::move(state)) << '\n';
+	} else if constexpr (Has_Part2<SolutionT>) {
+		part2_out << SolutionT::part2(std::move(state)) << '\n';
+	}
+}
+
+using Day_Solver = void (*)(Input_Source &input, uint part, std::ostream &part1_out, std::ostream &part2_out);
+
+struct Registered_Day {
+	int day;
+	Day_Solver solver;
+};
+
+[[nodiscard]] inline std::vector<Registered_Day> &registered_days() {
+	static std::vector<Registered_Day> days;
+	return days;
+}
+
+struct Day_Registration {
+	Day_Registration(int day, Day_Solver solver) {
+		registered_days().push_back(Registered_Day{day, solver});
+	}
+};
+
+struct Batch_Result {
+	std::string answers;
+	double time_ms;
+};
+
+/*
+ * Answer streams owned by each batch worker and reused for every file it solves. Only these buffers are reused: the
+ * days build their state in standard containers on the global heap, so there is no per-worker arena behind them.
+ */
+struct Batch_Scratch {
+	std::ostringstream part1_out;
+	std::ostringstream part2_out;
+
+	// Copy-assigning an empty string empties the buffers but, unlike str(""), keeps their capacity
+	void clear() {
+		static const std::string empty;
+		part1_out.str(empty);
+		part2_out.str(empty);
+	}
+};
+
+/*
+ * Solves one batch file, joining the answers onto one line. Multi-line answers (day 10's screen) keep their own lines.
+ */
+template<class SolutionT>
+Batch_Result solve_batch_file(const std::string &path, uint part) {
+	thread_local Batch_Scratch scratch;
+	const auto start = std::chrono::steady_clock::now();
+	scratch.clear();
+	Input_Source input{path};
+	solve_day<SolutionT>(input, part, scratch.part1_out, scratch.part2_out);
+
+	Batch_Result result{scratch.part1_out.str(), 0};
+	if (const auto answer2 = scratch.part2_out.view(); !answer2.empty()) {
+		if (!result.answers.empty())
+			result.answers.back() = answer2.find('\n') + 1 < answer2.size() ? '\n' : ' ';
+		result.answers += answer2;
+	}
+	if (!result.answers.empty() && result.answers.back() == '\n')
+		result.answers.pop_back();
+	result.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+/*
+ * Solves every file on a thread pool and prints "<path>: [<ms> ms] <answers>" for each, in the order given. The
+ * files already keep the pool busy, so each solve gets an equal share of its threads for any pool of its own.
+ * Returns non-zero if any file failed.
+ */
+template<class SolutionT>
+int run_batch(const std::vector<std::string> &paths, uint part) {
+	Thread_Pool pool{default_thread_count()};
+	const auto threads_per_file = pool.size() / std::max<std::size_t>(paths.size(), 1);
+	std::vector<std::future<Batch_Result>> results;
+	results.reserve(paths.size());
+	for (const auto &path : paths) {
+		results.push_back(pool.submit([&path, part, threads_per_file] {
+			Thread_Budget budget{threads_per_file};
+			return solve_batch_file<SolutionT>(path, part);
+		}));
+	}
+
+	int status{0};
+	for (std::size_t i = 0; i < paths.size(); ++i) {
+		std::cout << paths[i] << ':';
+		try {
+			const auto result = results[i].get();
+			std::cout << " [" << std::fixed << std::setprecision(2) << result.time_ms << " ms] " << result.answers << '\n';
+		} catch (const std::exception &e) {
+			std::cout << " error: " << e.what() << '\n';
+			status = 1;
+		}
+	}
+	std::cout << std::flush;
+	return status;
+}
+
+template<class SolutionT>
+int run_day(int argc, char *argv[]) {
+	const auto part = select_part(argc, argv);
+	int status{0};
+	if (const auto paths = batch_paths(argc, argv); !paths.empty()) {
+		status = run_batch<SolutionT>(paths, part);
+	} else {
+		Input_Source input;
+		solve_day<SolutionT>(input, part, std::cout, std::cout);
+	}
+	if (stats_requested())
+		report_stats(std::cerr);
+	return status;
+}
+
+#ifdef AOC_LIBRARY
+#define AOC_SOLUTION(DAY, SOLUTION) \
+	static const Day_Registration day_registration{DAY, solve_day<SOLUTION>};
+#else
+#define AOC_SOLUTION(DAY, SOLUTION) \
+	int main(int argc, char *argv[]) { \
+		return run_day<SOLUTION>(argc, argv); \
+	}
+#endif
@@ -0,0 +1,172 @@
+#include "common.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Multi-day runner: every day's solution is linked in as a library object (see AOC_SOLUTION), the selected day/part
+ * solves are scheduled on a work-stealing thread pool and the answers are printed in order as they complete. When both
+ * parts of a day are requested they come from a single solve that parses the input once. Each solve gets an equal
+ * share of the pool's threads (at least one) for any pool its solver starts, so days that search in parallel do not
+ * oversubscribe the cores the runner is already using.
+ */
+
+struct Options {
+	std::vector<int> days;
+	std::vector<int> parts{1, 2};
+	std::string input_dir{"input"};
+	std::size_t num_threads{default_thread_count()};
+	bool show_time{false};
+};
+
+struct Answer {
+	std::string text[2];
+	double time_ms;
+};
+
+struct Task {
+	int day;
+	int part;
+	std::shared_future<Answer> answer;
+};
+
+[[noreturn]] static void usage(const char *prog, int status) {
+	(status == 0 ? std::cout : std::cerr)
+			<< "Usage: " << prog << " [options]\n"
+			<< "  -d, --days LIST       days to solve, e.g. 1,5,16-19 (default: all)\n"
+			<< "  -p, --parts LIST      parts to solve (default 1,2)\n"
+			<< "  -i, --input-dir DIR   directory holding XX.txt inputs (default input)\n"
+			<< "  -j, --threads N       worker threads (default $AOC_THREADS or one per core)\n"
+			<< "  -t, --time            print the wall time of each solve\n"
+			<< "  -s, --stats           print instrumentation totals (stats builds only)\n";
+	std::exit(status);
+}
+
+static std::vector<int> parse_list(const std::string &list) {
+	std::vector<int> values;
+	for_each_token(list, ',', [&values](auto item) {
+		if (const auto dash = item.find('-'); dash != std::string_view::npos) {
+			for (auto value = parse_number(item.substr(0, dash)); value <= parse_number(item.substr(dash + 1)); ++value)
+				values.push_back(value);
+		} else {
+			values.push_back(parse_number(item));
+		}
+	});
+	return values;
+}
+
+static Options parse_options(int argc, char *argv[]) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg{argv[i]};
+		if (arg == "-h" || arg == "--help")
+			usage(argv[0], 0);
+		if (arg == "-t" || arg == "--time") {
+			options.show_time = true;
+			continue;
+		}
+		if (arg == "-s" || arg == "--stats") {
+			stats_requested() = true;
+			continue;
+		}
+		if (i + 1 == argc)
+			usage(argv[0], 1);
+		const std::string value{argv[++i]};
+		if (arg == "-d" || arg == "--days")
+			options.days = parse_list(value);
+		else if (arg == "-p" || arg == "--parts")
+			options.parts = parse_list(value);
+		else if (arg == "-i" || arg == "--input-dir")
+			options.input_dir = value;
+		else if (arg == "-j" || arg == "--threads")
+			options.num_threads = std::max<std::size_t>(parse_number<std::size_t>(value), 1);
+		else
+			usage(argv[0], 1);
+	}
+	if (options.days.empty()) {
+		for (const auto &registered : registered_days())
+			options.days.push_back(registered.day);
+		std::sort(options.days.begin(), options.days.end());
+	}
+	return options;
+}
+
+static std::string day_name(int day) {
+	std::ostringstream ss;
+	ss << std::setw(2) << std::setfill('0') << day;
+	return ss.str();
+}
+
+static Day_Solver find_solver(int day) {
+	const auto &days = registered_days();
+	const auto it = std::find_if(days.begin(), days.end(), [day](const auto &registered) { return registered.day == day; });
+	return it == days.end() ? nullptr : it->solver;
+}
+
+static Answer solve(Day_Solver solver, const std::string &input_path, uint part, std::size_t num_threads) {
+	Thread_Budget budget{num_threads};
+	const auto start = std::chrono::steady_clock::now();
+	Input_Source input{input_path};
+	std::ostringstream part1_out, part2_out;
+	solver(input, part, part1_out, part2_out);
+	return Answer{{part1_out.str(), part2_out.str()},
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()};
+}
+
+int main(int argc, char *argv[]) {
+	const auto options = parse_options(argc, argv);
+
+	const auto wants_part = [&options](int part) {
+		return std::find(options.parts.begin(), options.parts.end(), part) != options.parts.end();
+	};
+	const auto both_parts = wants_part(1) && wants_part(2);
+	const auto solves_per_day = options.parts.size() - (both_parts ? 1 : 0);
+	const auto threads_per_solve = options.num_threads / std::max<std::size_t>(options.days.size() * solves_per_day, 1);
+
+	Thread_Pool pool{options.num_threads};
+	std::vector<Task> tasks;
+	for (auto day : options.days) {
+		const auto solver = find_solver(day);
+		if (solver == nullptr) {
+			std::cerr << argv[0] << ": no solution for day " << day << std::endl;
+			return 1;
+		}
+		const auto input_path = options.input_dir + "/" + day_name(day) + ".txt";
+		std::shared_future<Answer> both;
+		if (both_parts) {
+			both = pool.submit([solver, input_path, threads_per_solve] {
+				return solve(solver, input_path, BOTH_PARTS, threads_per_solve);
+			});
+		}
+		for (auto part : options.parts) {
+			tasks.push_back(Task{day, part, both.valid() && (part == 1 || part == 2) ? both : pool.submit([solver, input_path, part, threads_per_solve] {
+				return solve(solver, input_path, part, threads_per_solve);
+			}).share()});
+		}
+	}
+
+	int status{0};
+	for (auto &task : tasks) {
+		std::cout << "Day " << day_name(task.day) << ", part " << task.part << ":";
+		try {
+			const auto &answer = task.answer.get();
+			const auto &text = answer.text[task.part == 2];
+			if (options.show_time)
+				std::cout << " [" << std::fixed << std::setprecision(2) << answer.time_ms << " ms]";
+			// Multi-line answers (day 10's screen) start on their own line
+			const auto first_newline = text.find('\n');
+			std::cout << (first_newline + 1 < text.size() ? '\n' : ' ');
+			std::cout << (text.empty() ? "\n" : text) << std::flush;
+		} catch (const std::exception &e) {
+			std::cout << " error: " << e.what() << std::endl;
+			status = 1;
+		}
+	}
+	if (stats_requested())
+		report_stats(std::cerr);
+	return status;
+}
@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * Benchmark driver: runs each ./bin/XX part a number of times against its input, reports wall time statistics and
+ * peak RSS, writes the results as JSON and optionally compares the medians against a stored baseline. With a list of
+ * thread counts each part is also run once per count (through $AOC_THREADS) and its speedup over the first is shown.
+ */
+
+struct Options {
+	std::size_t runs{5};
+	std::vector<int> days;
+	std::vector<int> parts{1, 2};
+	std::string bin_dir{"bin"};
+	std::string input_dir{"input"};
+	std::string json_path;
+	std::string csv_path;
+	std::string baseline_path;
+	std::string label;
+	double threshold_pct{10.0};
+	rlim_t timeout_sec{0};
+	std::size_t scale{0};
+	std::vector<int> threads;
+};
+
+enum class Status { OK, FAILED, TIMEOUT };
+
+struct Result {
+	std::string day;
+	int part;
+	int threads;
+	Status status{Status::OK};
+	std::vector<double> times_ms;
+	long max_rss_kb{0};
+
+	[[nodiscard]] double min_ms() const {
+		return times_ms.front();
+	}
+
+	[[nodiscard]] double median_ms() const {
+		const auto mid = times_ms.size() / 2;
+		return times_ms.size() % 2 == 1 ? times_ms[mid] : (times_ms[mid - 1] + times_ms[mid]) / 2;
+	}
+
+	[[nodiscard]] double p95_ms() const {
+		const auto rank = static_cast<std::size_t>(std::ceil(0.95 * times_ms.size()));
+		return times_ms[std::max<std::size_t>(rank, 1) - 1];
+	}
+};
+
+struct Baseline_Entry {
+	std::string day;
+	int part;
+	int threads;
+	double median_ms;
+};
+
+[[noreturn]] static void usage(const char *prog, int status) {
+	(status == 0 ? std::cout : std::cerr)
+			<< "Usage: " << prog << " [options]\n"
+			<< "  -n, --runs N          runs per day/part (default 5)\n"
+			<< "  -d, --days LIST       days to run, e.g. 1,5,16-19 (default: all built days)\n"
+			<< "  -p, --parts LIST      parts to run (default 1,2)\n"
+			<< "  -i, --input-dir DIR   directory holding XX.txt inputs (default input)\n"
+			<< "  -o, --json FILE       write results as JSON to FILE\n"
+			<< "  -b, --baseline FILE   compare medians against a JSON file written by --json\n"
+			<< "  -t, --threshold PCT   median slowdown that counts as a regression (default 10)\n"
+			<< "  -T, --timeout SEC     CPU time limit per run (default none)\n"
+			<< "  -l, --label TEXT      label stored with the results\n"
+			<< "  -s, --scale N         generator scale of the inputs, stored with the results\n"
+			<< "  -c, --csv FILE        append results as CSV rows to FILE (for plotting against scale)\n"
+			<< "  -j, --threads LIST    run each part with each $AOC_THREADS count, e.g. 1,2,4-8, and report speedups\n";
+	std::exit(status);
+}
+
+static std::vector<int> parse_list(const std::string &list) {
+	std::vector<int> values;
+	std::stringstream ss{list};
+	for (std::string item; std::getline(ss, item, ','); ) {
+		if (const auto dash = item.find('-'); dash != std::string::npos) {
+			for (auto value = std::stoi(item.substr(0, dash)); value <= std::stoi(item.substr(dash + 1)); ++value)
+				values.push_back(value);
+		} else {
+			values.push_back(std::stoi(item));
+		}
+	}
+	return values;
+}
+
+static Options parse_options(int argc, char *argv[]) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg{argv[i]};
+		if (arg == "-h" || arg == "--help")
+			usage(argv[0], 0);
+		if (i + 1 == argc)
+			usage(argv[0], 1);
+		const std::string value{argv[++i]};
+		if (arg == "-n" || arg == "--runs")
+			options.runs = std::max(1, std::stoi(value));
+		else if (arg == "-d" || arg == "--days")
+			options.days = parse_list(value);
+		else if (arg == "-p" || arg == "--parts")
+			options.parts = parse_list(value);
+		else if (arg == "-i" || arg == "--input-dir")
+			options.input_dir = value;
+		else if (arg == "-o" || arg == "--json")
+			options.json_path = value;
+		else if (arg == "-b" || arg == "--baseline")
+			options.baseline_path = value;
+		else if (arg == "-t" || arg == "--threshold")
+			options.threshold_pct = std::stod(value);
+		else if (arg == "-T" || arg == "--timeout")
+			options.timeout_sec = std::stoul(value);
+		else if (arg == "-l" || arg == "--label")
+			options.label = value;
+		else if (arg == "-s" || arg == "--scale")
+			options.scale = std::stoul(value);
+		else if (arg == "-c" || arg == "--csv")
+			options.csv_path = value;
+		else if (arg == "-j" || arg == "--threads")
+			options.threads = parse_list(value);
+		else
+			usage(argv[0], 1);
+	}
+	if (options.days.empty()) {
+		for (int day = 1; day <= 25; ++day)
+			options.days.push_back(day);
+	}
+	// 0 leaves $AOC_THREADS as it is
+	if (options.threads.empty())
+		options.threads.push_back(0);
+	return options;
+}
+
+static bool file_exists(const std::string &path) {
+	struct stat file_stat;
+	return stat(path.c_str(), &file_stat) == 0;
+}
+
+static std::string day_name(int day) {
+	std::ostringstream ss;
+	ss << std::setw(2) << std::setfill('0') << day;
+	return ss.str();
+}
+
+/*
+ * Runs the solver once with stdin redirected from the input file and stdout discarded, returning the wall time in
+ * milliseconds and the child's peak RSS.
+ */
+static Status run_once(const Options &options, const std::string &bin_path, const std::string &input_path,
+					   int part, int threads, double &time_ms, long &max_rss_kb) {
+	const auto part_arg = std::to_string(part);
+	const auto start = std::chrono::steady_clock::now();
+	const auto pid = fork();
+	if (pid < 0) {
+		std::perror("fork");
+		return Status::FAILED;
+	}
+	if (pid == 0) {
+		const auto in_fd = open(input_path.c_str(), O_RDONLY);
+		const auto null_fd = open("/dev/null", O_WRONLY);
+		if (in_fd < 0 || null_fd < 0 || dup2(in_fd, STDIN_FILENO) < 0 || dup2(null_fd, STDOUT_FILENO) < 0)
+			_exit(127);
+		if (options.timeout_sec > 0) {
+			const rlimit limit{options.timeout_sec, options.timeout_sec + 1};
+			setrlimit(RLIMIT_CPU, &limit);
+		}
+		if (threads > 0)
+			setenv("AOC_THREADS", std::to_string(threads).c_str(), 1);
+		execl(bin_path.c_str(), bin_path.c_str(), part_arg.c_str(), static_cast<char *>(nullptr));
+		_exit(127);
+	}
+
+	int wstatus;
+	rusage usage;
+	if (wait4(pid, &wstatus, 0, &usage) < 0) {
+		std::perror("wait4");
+		return Status::FAILED;
+	}
+	time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	max_rss_kb = usage.ru_maxrss;
+	if (WIFSIGNALED(wstatus) && (WTERMSIG(wstatus) == SIGXCPU || WTERMSIG(wstatus) == SIGKILL))
+		return Status::TIMEOUT;
+	if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0)
+		return Status::FAILED;
+	return Status::OK;
+}
+
+static Result run_benchmark(const Options &options, int day, int part, int threads) {
+	Result result{day_name(day), part, threads, Status::OK, {}, 0};
+	const auto bin_path = options.bin_dir + "/" + result.day;
+	const auto input_path = options.input_dir + "/" + result.day + ".txt";
+	for (std::size_t run = 0; run < options.runs && result.status == Status::OK; ++run) {
+		double time_ms{0};
+		long max_rss_kb{0};
+		result.status = run_once(options, bin_path, input_path, part, threads, time_ms, max_rss_kb);
+		result.times_ms.push_back(time_ms);
+		result.max_rss_kb = std::max(result.max_rss_kb, max_rss_kb);
+	}
+	std::sort(result.times_ms.begin(), result.times_ms.end());
+	return result;
+}
+
+static const char *status_name(Status status) {
+	switch (status) {
+	case Status::OK: return "ok";
+	case Status::FAILED: return "failed";
+	case Status::TIMEOUT: default: return "timeout";
+	}
+}
+
+static std::string json_escape(const std::string &str) {
+	std::string escaped;
+	for (auto c : str) {
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		escaped += c;
+	}
+	return escaped;
+}
+
+static void write_json(const Options &options, const std::vector<Result> &results) {
+	std::ofstream out{options.json_path};
+	if (!out)
+		throw std::runtime_error{"Cannot write " + options.json_path};
+	out << std::fixed << std::setprecision(3);
+	out << "{\n"
+		<< "  \"label\": \"" << json_escape(options.label) << "\",\n"
+		<< "  \"runs\": " << options.runs << ",\n"
+		<< "  \"scale\": " << options.scale << ",\n"
+		<< "  \"results\": [\n";
+	for (auto it = results.begin(); it != results.end(); ++it) {
+		out << "    {\"day\": \"" << it->day << "\", \"part\": " << it->part
+			<< ", \"threads\": " << it->threads
+			<< ", \"status\": \"" << status_name(it->status) << "\""
+			<< ", \"min_ms\": " << it->min_ms()
+			<< ", \"median_ms\": " << it->median_ms()
+			<< ", \"p95_ms\": " << it->p95_ms()
+			<< ", \"max_rss_kb\": " << it->max_rss_kb << "}"
+			<< (std::next(it) == results.end() ? "\n" : ",\n");
+	}
+	out << "  ]\n"
+		<< "}\n";
+}
+
+/*
+ * Reads the result objects back out of a file written by write_json(). Only the flat result objects are
+ * understood, which is all that is needed to compare medians.
+ */
+static std::vector<Baseline_Entry> read_baseline(const std::string &path) {
+	std::ifstream in{path};
+	if (!in)
+		throw std::runtime_error{"Cannot read baseline " + path};
+	const std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+
+	const auto field = [](const std::string &object, const std::string &key) -> std::optional<std::string> {
+		auto pos = object.find("\"" + key + "\"");
+		if (pos == std::string::npos)
+			return std::nullopt;
+		pos = object.find_first_not_of(" \t\n:", object.find(':', pos));
+		const auto end = object[pos] == '"' ? object.find('"', ++pos) : object.find_first_of(",} \t\n", pos);
+		return object.substr(pos, end - pos);
+	};
+
+	std::vector<Baseline_Entry> entries;
+	for (auto start = text.find('{', text.find("\"results\"")); start != std::string::npos; start = text.find('{', start + 1)) {
+		const auto object = text.substr(start, text.find('}', start) - start);
+		const auto day = field(object, "day"), part = field(object, "part"), median = field(object, "median_ms");
+		const auto status = field(object, "status"), threads = field(object, "threads");
+		if (day && part && median && (!status || *status == "ok"))
+			entries.push_back(Baseline_Entry{*day, std::stoi(*part), threads ? std::stoi(*threads) : 0, std::stod(*median)});
+	}
+	return entries;
+}
+
+static std::optional<double> baseline_median(const std::vector<Baseline_Entry> &baseline, const Result &result) {
+	const auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const auto &entry) {
+		return entry.day == result.day && entry.part == result.part && entry.threads == result.threads;
+	});
+	return it == baseline.end() ? std::nullopt : std::optional<double>{it->median_ms};
+}
+
+/*
+ * Appends one row per result, writing the header first if the file is new, so runs at several scales accumulate into
+ * a single table.
+ */
+static void append_csv(const Options &options, const std::vector<Result> &results) {
+	const auto is_new = !file_exists(options.csv_path);
+	std::ofstream out{options.csv_path, std::ios::app};
+	if (!out)
+		throw std::runtime_error{"Cannot write " + options.csv_path};
+	out << std::fixed << std::setprecision(3);
+	if (is_new)
+		out << "label,scale,day,part,status,min_ms,median_ms,p95_ms,max_rss_kb,threads\n";
+	for (const auto &result : results) {
+		out << options.label << ',' << options.scale << ',' << result.day << ',' << result.part << ','
+			<< status_name(result.status) << ',' << result.min_ms() << ',' << result.median_ms() << ','
+			<< result.p95_ms() << ',' << result.max_rss_kb << ',' << result.threads << '\n';
+	}
+}
+
+int main(int argc, char *argv[]) {
+	const auto options = parse_options(argc, argv);
+	std::vector<Baseline_Entry> baseline;
+	if (!options.baseline_path.empty()) {
+		if (file_exists(options.baseline_path))
+			baseline = read_baseline(options.baseline_path);
+		else
+			std::cerr << "No baseline at " << options.baseline_path << ", skipping comparison" << std::endl;
+	}
+
+	const auto show_threads = options.threads.size() > 1 || options.threads.front() > 0;
+	std::cout << "Day Part " << (show_threads ? "Threads " : "") << std::setw(12) << "min (ms)" << std::setw(12) << "median (ms)"
+			  << std::setw(12) << "p95 (ms)" << std::setw(12) << "RSS (KB)" << std::setw(12) << "baseline"
+			  << (show_threads ? "     speedup" : "") << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	std::vector<Result> results;
+	int regressions{0}, failures{0};
+	for (auto day : options.days) {
+		for (auto part : options.parts) {
+			const auto name = day_name(day);
+			if (!file_exists(options.bin_dir + "/" + name) || !file_exists(options.input_dir + "/" + name + ".txt"))
+				continue;
+
+			const auto first = results.size();
+			for (auto threads : options.threads) {
+				const auto &result = results.emplace_back(run_benchmark(options, day, part, threads));
+				std::cout << result.day << "  " << std::setw(3) << part << " ";
+				if (show_threads)
+					std::cout << std::setw(7) << threads << " ";
+				std::cout << std::setw(12) << result.min_ms() << std::setw(12) << result.median_ms() << std::setw(12) << result.p95_ms()
+						  << std::setw(12) << result.max_rss_kb;
+				const auto base = baseline_median(baseline, result);
+				if (result.status != Status::OK) {
+					std::cout << std::setw(12) << status_name(result.status);
+					if (result.status == Status::FAILED)
+						++failures;
+					else if (base)
+						++regressions;
+				} else if (base) {
+					const auto change_pct = (result.median_ms() - *base) / *base * 100;
+					std::cout << std::setw(11) << std::showpos << change_pct << std::noshowpos << "%";
+					if (change_pct > options.threshold_pct) {
+						++regressions;
+						std::cout << "  REGRESSION";
+					}
+				} else if (show_threads) {
+					std::cout << std::setw(12) << "";
+				}
+				// Speedup over the same part run with the first thread count
+				if (show_threads && result.status == Status::OK && results[first].status == Status::OK)
+					std::cout << std::setw(11) << results[first].median_ms() / result.median_ms() << "x";
+				std::cout << std::endl;
+			}
+		}
+	}
+
+	if (!options.json_path.empty())
+		write_json(options, results);
+	if (!options.csv_path.empty())
+		append_csv(options, results);
+	if (regressions > 0)
+		std::cout << regressions << " regression(s) above " << options.threshold_pct << "%" << std::endl;
+	if (failures > 0)
+		std::cout << failures << " run(s) failed" << std::endl;
+	return regressions > 0 || failures > 0 ? 1 : 0;
+}
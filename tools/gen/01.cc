@@ -0,0 +1,16 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t elf = 0; elf < scale; ++elf) {
+		if (elf > 0)
+			out << '\n';
+		for (auto items = random.uniform(1, 15); items > 0; --items)
+			out << random.uniform(1000, 60000) << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(1, generate, 250, "elves")
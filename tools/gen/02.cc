@@ -0,0 +1,12 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t round = 0; round < scale; ++round)
+		out << static_cast<char>('A' + random.uniform(0, 2)) << ' ' << static_cast<char>('X' + random.uniform(0, 2)) << '\n';
+}
+
+}
+
+AOC_GENERATOR(2, generate, 2500, "rounds")
@@ -0,0 +1,39 @@
+#include "gen.h"
+#include <string>
+
+namespace {
+
+static constexpr std::string_view ITEMS{"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+
+/*
+ * A compartment of the given length holding each of the required items at least once, filled up from the pool.
+ */
+static std::string compartment(std::string required, std::string_view pool, std::size_t length, Random &random) {
+	while (required.size() < length)
+		required.push_back(pool[random.uniform<std::size_t>(0, pool.size() - 1)]);
+	random.shuffle(required.begin(), required.end());
+	return required;
+}
+
+/*
+ * Each group of three draws its rucksacks from disjoint pools of 17 item types plus the shared badge, so the badge is
+ * the only item common to the group. Within a rucksack the two compartments share only the mismatched item.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t group = 0; group < (scale + 2) / 3; ++group) {
+		std::string items{ITEMS};
+		random.shuffle(items.begin(), items.end());
+		const auto badge = items[0];
+		for (std::size_t elf = 0; elf < 3; ++elf) {
+			const auto pool = std::string_view{items}.substr(1 + 17 * elf, 17);
+			const auto mismatch = pool[0];
+			const auto length = random.uniform<std::size_t>(4, 16);
+			out << compartment({mismatch, badge}, pool.substr(1, 8), length, random)
+				<< compartment({mismatch}, pool.substr(9, 8), length, random) << '\n';
+		}
+	}
+}
+
+}
+
+AOC_GENERATOR(3, generate, 300, "rucksacks (rounded up to groups of 3)")
@@ -0,0 +1,15 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t pair = 0; pair < scale; ++pair) {
+		const auto first_start = random.uniform(1, 99), second_start = random.uniform(1, 99);
+		out << first_start << '-' << random.uniform(first_start, 99) << ','
+			<< second_start << '-' << random.uniform(second_start, 99) << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(4, generate, 1000, "assignment pairs")
@@ -0,0 +1,30 @@
+#include "gen.h"
+#include <array>
+
+namespace {
+
+/*
+ * The starting stacks are built into the solution, so the moves are simulated against their heights and never
+ * empty a stack.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	std::array<int, 9> heights{7, 4, 3, 8, 8, 6, 7, 8, 5};
+	for (std::size_t move = 0; move < scale; ++move) {
+		std::size_t from;
+		do {
+			from = random.uniform<std::size_t>(0, heights.size() - 1);
+		} while (heights[from] < 2);
+		std::size_t to;
+		do {
+			to = random.uniform<std::size_t>(0, heights.size() - 1);
+		} while (to == from);
+		const auto count = random.uniform(1, heights[from] - 1);
+		heights[from] -= count;
+		heights[to] += count;
+		out << "move " << count << " from " << from + 1 << " to " << to + 1 << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(5, generate, 500, "moves")
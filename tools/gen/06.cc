@@ -0,0 +1,20 @@
+#include "gen.h"
+#include <string>
+
+namespace {
+
+/*
+ * Three letters repeated until the last 14 characters, which are all distinct: both markers sit at the very end.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	std::string buffer;
+	for (std::size_t i = 14; i < scale; ++i)
+		buffer.push_back(static_cast<char>('a' + random.uniform(0, 2)));
+	std::string tail{"defghijklmnopqrstuvwxyz"};
+	random.shuffle(tail.begin(), tail.end());
+	out << buffer << tail.substr(0, 14) << '\n';
+}
+
+}
+
+AOC_GENERATOR(6, generate, 4096, "characters (at least 14)")
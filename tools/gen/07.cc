@@ -0,0 +1,72 @@
+#include "gen.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr std::uint64_t MIN_USED_SPACE{40000001};
+
+struct Entry {
+	std::string name;
+	bool is_dir;
+	std::uint64_t size;
+	std::vector<std::size_t> children;
+};
+
+static std::string entry_name(std::size_t id) {
+	std::string name;
+	do {
+		name.push_back(static_cast<char>('a' + id % 26));
+		id /= 26;
+	} while (id > 0);
+	return name;
+}
+
+static void write_listing(std::ostream &out, const std::vector<Entry> &entries, std::size_t dir) {
+	out << "$ ls\n";
+	for (auto child : entries[dir].children) {
+		if (entries[child].is_dir)
+			out << "dir " << entries[child].name << '\n';
+		else
+			out << entries[child].size << ' ' << entries[child].name << '\n';
+	}
+	for (auto child : entries[dir].children) {
+		if (entries[child].is_dir) {
+			out << "$ cd " << entries[child].name << '\n';
+			write_listing(out, entries, child);
+			out << "$ cd ..\n";
+		}
+	}
+}
+
+/*
+ * A random recursive tree of files and directories, explored depth first. File sizes are spread so the disk is
+ * between 40M and 70M full, which keeps part 2's deletion target positive.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	std::vector<Entry> entries{Entry{"/", true, 0, {}}};
+	std::vector<std::size_t> dirs{0};
+	std::vector<std::size_t> files;
+	const auto budget = MIN_USED_SPACE + random.uniform<std::uint64_t>(1000000, 25000000);
+	const auto mean_size = std::max<std::uint64_t>(budget / std::max<std::size_t>(scale * 7 / 10, 1), 1);
+	for (std::size_t id = 1; id < std::max<std::size_t>(scale, 2); ++id) {
+		const auto parent = random.pick(dirs);
+		const auto is_dir = id > 1 && random.chance(0.3);
+		entries[parent].children.push_back(entries.size());
+		(is_dir ? dirs : files).push_back(entries.size());
+		entries.push_back(Entry{entry_name(id) + (is_dir ? "" : ".txt"), is_dir, is_dir ? 0 : random.uniform<std::uint64_t>(1, 2 * mean_size), {}});
+	}
+
+	std::uint64_t used{0};
+	for (auto file : files)
+		used += entries[file].size;
+	if (used < MIN_USED_SPACE)
+		entries[files.front()].size += MIN_USED_SPACE - used;
+
+	out << "$ cd /\n";
+	write_listing(out, entries, 0);
+}
+
+}
+
+AOC_GENERATOR(7, generate, 1000, "files and directories")
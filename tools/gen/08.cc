@@ -0,0 +1,15 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t r = 0; r < scale; ++r) {
+		for (std::size_t c = 0; c < scale; ++c)
+			out << static_cast<char>('0' + random.uniform(0, 9));
+		out << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(8, generate, 99, "grid side")
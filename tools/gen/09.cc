@@ -0,0 +1,13 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	static constexpr char DIRECTIONS[]{'R', 'L', 'U', 'D'};
+	for (std::size_t move = 0; move < scale; ++move)
+		out << DIRECTIONS[random.uniform(0, 3)] << ' ' << random.uniform(1, 20) << '\n';
+}
+
+}
+
+AOC_GENERATOR(9, generate, 2000, "moves")
@@ -0,0 +1,27 @@
+#include "gen.h"
+#include <algorithm>
+
+namespace {
+
+/*
+ * The CRT is a fixed 40x6 screen, so every program runs for exactly 240 cycles; the scale only sets how many of them
+ * are spent in addx rather than noop (percent). The register is kept on screen so the sprite draws something.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	int reg_x{1};
+	for (int cycles = 240; cycles > 0; ) {
+		if (cycles >= 2 && random.chance(std::min<std::size_t>(scale, 100) / 100.0)) {
+			const auto value = std::clamp(random.uniform(-10, 10), -reg_x, 39 - reg_x);
+			reg_x += value;
+			out << "addx " << value << '\n';
+			cycles -= 2;
+		} else {
+			out << "noop\n";
+			--cycles;
+		}
+	}
+}
+
+}
+
+AOC_GENERATOR(10, generate, 70, "percent of cycles spent in addx")
@@ -0,0 +1,40 @@
+#include "gen.h"
+#include <array>
+
+namespace {
+
+/*
+ * The monkey ids are single digits, so there are always eight monkeys testing distinct primes (keeping part 2's
+ * modulus small); the scale sets the average number of starting items per monkey.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	static constexpr std::size_t NUM_MONKEYS{8};
+	std::array<int, NUM_MONKEYS> tests{2, 3, 5, 7, 11, 13, 17, 19};
+	random.shuffle(tests.begin(), tests.end());
+	const auto squaring_monkey = random.uniform<std::size_t>(0, NUM_MONKEYS - 1);
+	for (std::size_t id = 0; id < NUM_MONKEYS; ++id) {
+		if (id > 0)
+			out << '\n';
+		out << "Monkey " << id << ":\n  Starting items: ";
+		for (std::size_t item = 0, count = random.uniform<std::size_t>(1, 2 * std::max<std::size_t>(scale, 1)); item < count; ++item)
+			out << (item > 0 ? ", " : "") << random.uniform(50, 99);
+		out << "\n  Operation: new = ";
+		if (id == squaring_monkey)
+			out << "old * old";
+		else if (random.chance(0.25))
+			out << "old * " << random.uniform(2, 19);
+		else
+			out << "old + " << random.uniform(1, 8);
+		const auto if_true = (id + random.uniform<std::size_t>(1, NUM_MONKEYS - 1)) % NUM_MONKEYS;
+		auto if_false = if_true;
+		while (if_false == if_true || if_false == id)
+			if_false = random.uniform<std::size_t>(0, NUM_MONKEYS - 1);
+		out << "\n  Test: divisible by " << tests[id]
+			<< "\n    If true: throw to monkey " << if_true
+			<< "\n    If false: throw to monkey " << if_false << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(11, generate, 4, "starting items per monkey")
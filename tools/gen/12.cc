@@ -0,0 +1,37 @@
+#include "gen.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*
+ * Heights rise by one letter every width/26 columns. Random dips and peaks scatter detours across the map, but the
+ * middle row is left untouched so S (left edge) can always reach E (right edge).
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const auto width = std::max<std::size_t>(scale, 26), height = std::max<std::size_t>(width / 4, 3);
+	const auto path_row = height / 2;
+	for (std::size_t r = 0; r < height; ++r) {
+		std::string row(width, 'a');
+		for (std::size_t c = 0; c < width; ++c) {
+			auto level = static_cast<int>(c * 26 / width);
+			if (r != path_row) {
+				if (random.chance(0.15))
+					level -= random.uniform(1, 3);
+				else if (random.chance(0.1))
+					level += random.uniform(2, 4);
+			}
+			row[c] = static_cast<char>('a' + std::clamp(level, 0, 25));
+		}
+		if (r == path_row) {
+			row.front() = 'S';
+			row.back() = 'E';
+		}
+		out << row << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(12, generate, 160, "map width (height is a quarter of it)")
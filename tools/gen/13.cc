@@ -0,0 +1,31 @@
+#include "gen.h"
+
+namespace {
+
+static void write_packet(std::ostream &out, int depth, Random &random) {
+	out << '[';
+	for (int i = 0, length = random.uniform(0, 5); i < length; ++i) {
+		if (i > 0)
+			out << ',';
+		if (depth < 4 && random.chance(0.3))
+			write_packet(out, depth + 1, random);
+		else
+			out << random.uniform(0, 10);
+	}
+	out << ']';
+}
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t pair = 0; pair < scale; ++pair) {
+		if (pair > 0)
+			out << '\n';
+		write_packet(out, 0, random);
+		out << '\n';
+		write_packet(out, 0, random);
+		out << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(13, generate, 150, "packet pairs")
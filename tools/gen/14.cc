@@ -0,0 +1,30 @@
+#include "gen.h"
+#include <algorithm>
+
+namespace {
+
+static constexpr int MIN_X{400}, MAX_X{600}, MIN_Y{13}, MAX_Y{170};
+
+/*
+ * Paths of alternating horizontal and vertical segments inside a fixed box below the sand source. The box keeps the
+ * part 2 floor triangle within the solution's 1000 columns.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t path = 0; path < scale; ++path) {
+		int x{random.uniform(MIN_X, MAX_X)}, y{random.uniform(MIN_Y, MAX_Y)};
+		out << x << ',' << y;
+		for (int segment = 0, count = random.uniform(1, 4); segment < count; ++segment) {
+			const auto length = random.uniform(-8, 8);
+			if (segment % 2 == 0)
+				x = std::clamp(x + length, MIN_X, MAX_X);
+			else
+				y = std::clamp(y + length, MIN_Y, MAX_Y);
+			out << " -> " << x << ',' << y;
+		}
+		out << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(14, generate, 140, "rock paths")
@@ -0,0 +1,42 @@
+#include "gen.h"
+#include <cstdlib>
+
+namespace {
+
+static constexpr long SEARCH_MAX{4000000};
+
+struct Point {
+	long x, y;
+};
+
+static long distance(const Point &lhs, const Point &rhs) {
+	return std::abs(lhs.x - rhs.x) + std::abs(lhs.y - rhs.y);
+}
+
+static void write_sensor(std::ostream &out, const Point &sensor, long range, Random &random) {
+	const auto dx = random.uniform(0L, range);
+	const Point beacon{sensor.x + (random.chance(0.5) ? dx : -dx), sensor.y + (random.chance(0.5) ? range - dx : dx - range)};
+	out << "Sensor at x=" << sensor.x << ", y=" << sensor.y
+		<< ": closest beacon is at x=" << beacon.x << ", y=" << beacon.y << '\n';
+}
+
+/*
+ * Every sensor reaches to just short of a hidden distress beacon. With a sensor in each corner of the search area
+ * that already covers everything else, so the extra sensors only add work and the part 2 answer stays unique.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const Point hidden{random.uniform(1L, SEARCH_MAX - 1), random.uniform(1L, SEARCH_MAX - 1)};
+	for (const auto &corner : {Point{0, 0}, Point{SEARCH_MAX, 0}, Point{0, SEARCH_MAX}, Point{SEARCH_MAX, SEARCH_MAX}})
+		write_sensor(out, corner, distance(corner, hidden) - 1, random);
+	for (std::size_t i = 4; i < scale; ++i) {
+		Point sensor;
+		do {
+			sensor = Point{random.uniform(0L, SEARCH_MAX), random.uniform(0L, SEARCH_MAX)};
+		} while (distance(sensor, hidden) < 2);
+		write_sensor(out, sensor, random.uniform(1L, distance(sensor, hidden) - 1), random);
+	}
+}
+
+}
+
+AOC_GENERATOR(15, generate, 35, "sensors (at least 4)")
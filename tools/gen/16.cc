@@ -0,0 +1,65 @@
+#include "gen.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The most flowing valves day 16 accepts (MAX_FLOWING_VALVES in src/16.cc)
+static constexpr std::size_t MAX_FLOWING_VALVES{48};
+
+/*
+ * A connected tunnel network of two-letter valves starting at AA, a quarter of which have a non-zero flow rate
+ * (about the ratio of the real puzzle), up to as many as the solver takes. A random tree plus a few extra tunnels
+ * keeps the degrees low.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const auto num_valves = std::clamp<std::size_t>(scale, 2, 26 * 26);
+	std::vector<std::string> names;
+	for (char first = 'A'; first <= 'Z'; ++first) {
+		for (char second = 'A'; second <= 'Z'; ++second) {
+			if (first != 'A' || second != 'A')
+				names.push_back(std::string{first, second});
+		}
+	}
+	random.shuffle(names.begin(), names.end());
+	names.insert(names.begin(), "AA");
+	names.resize(num_valves);
+
+	std::vector<int> rates(num_valves, 0);
+	const auto num_flowing = std::clamp<std::size_t>(num_valves / 4, 1, MAX_FLOWING_VALVES);
+	for (std::size_t valve = 1; valve <= num_flowing; ++valve)
+		rates[valve] = random.uniform(3, 25);
+
+	std::vector<std::set<std::size_t>> tunnels(num_valves);
+	const auto connect = [&tunnels](std::size_t lhs, std::size_t rhs) {
+		if (lhs != rhs) {
+			tunnels[lhs].insert(rhs);
+			tunnels[rhs].insert(lhs);
+		}
+	};
+	std::vector<std::size_t> order(num_valves);
+	for (std::size_t i = 0; i < num_valves; ++i)
+		order[i] = i;
+	random.shuffle(order.begin(), order.end());
+	for (std::size_t i = 1; i < num_valves; ++i)
+		connect(order[i], order[random.uniform<std::size_t>(i > 8 ? i - 8 : 0, i - 1)]);
+	for (std::size_t i = 0; i < num_valves / 5; ++i)
+		connect(random.uniform<std::size_t>(0, num_valves - 1), random.uniform<std::size_t>(0, num_valves - 1));
+
+	for (auto valve : order) {
+		out << "Valve " << names[valve] << " has flow rate=" << rates[valve]
+			<< (tunnels[valve].size() == 1 ? "; tunnel leads to valve " : "; tunnels lead to valves ");
+		bool first{true};
+		for (auto nbr : tunnels[valve]) {
+			out << (first ? "" : ", ") << names[nbr];
+			first = false;
+		}
+		out << '\n';
+	}
+}
+
+}
+
+AOC_GENERATOR(16, generate, 58, "valves (at most 676, of which at most 48 flow)")
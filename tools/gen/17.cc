@@ -0,0 +1,13 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t jet = 0; jet < scale; ++jet)
+		out << (random.chance(0.5) ? '<' : '>');
+	out << '\n';
+}
+
+}
+
+AOC_GENERATOR(17, generate, 10091, "jets")
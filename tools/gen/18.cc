@@ -0,0 +1,22 @@
+#include "gen.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/*
+ * Distinct cubes scattered over a box about twice their number in volume, which leaves plenty of enclosed air pockets.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const auto side = static_cast<std::size_t>(std::ceil(std::cbrt(2.0 * scale))) + 1;
+	std::vector<std::size_t> cells(side * side * side);
+	for (std::size_t i = 0; i < cells.size(); ++i)
+		cells[i] = i;
+	random.shuffle(cells.begin(), cells.end());
+	for (std::size_t i = 0; i < std::min(scale, cells.size()); ++i)
+		out << cells[i] / (side * side) + 1 << ',' << cells[i] / side % side + 1 << ',' << cells[i] % side + 1 << '\n';
+}
+
+}
+
+AOC_GENERATOR(18, generate, 2700, "cubes")
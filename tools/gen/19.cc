@@ -0,0 +1,17 @@
+#include "gen.h"
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	for (std::size_t id = 1; id <= std::max<std::size_t>(scale, 3); ++id) {
+		out << "Blueprint " << id << ": Each ore robot costs " << random.uniform(2, 4)
+			<< " ore. Each clay robot costs " << random.uniform(2, 4)
+			<< " ore. Each obsidian robot costs " << random.uniform(2, 4) << " ore and " << random.uniform(5, 20)
+			<< " clay. Each geode robot costs " << random.uniform(2, 4) << " ore and " << random.uniform(5, 20)
+			<< " obsidian.\n";
+	}
+}
+
+}
+
+AOC_GENERATOR(19, generate, 30, "blueprints (at least 3)")
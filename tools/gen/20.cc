@@ -0,0 +1,20 @@
+#include "gen.h"
+#include <vector>
+
+namespace {
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	std::vector<int> numbers(std::max<std::size_t>(scale, 1), 0);
+	for (std::size_t i = 1; i < numbers.size(); ++i) {
+		do {
+			numbers[i] = random.uniform(-10000, 10000);
+		} while (numbers[i] == 0);
+	}
+	random.shuffle(numbers.begin(), numbers.end());
+	for (auto number : numbers)
+		out << number << '\n';
+}
+
+}
+
+AOC_GENERATOR(20, generate, 5000, "numbers")
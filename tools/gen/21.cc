@@ -0,0 +1,174 @@
+#include "gen.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr long GROWTH_LIMIT{1000000000};
+
+/*
+ * Builds the tree bottom-up from the values each monkey must yell, so every division is exact. humn sits at the bottom
+ * of a path of operations below root; its listed number is the one that makes both sides of root equal, which keeps
+ * the part 2 inversion exact as well.
+ */
+struct Tree_Builder {
+	Tree_Builder(std::size_t num_monkeys, Random &random)
+		: random_{random},
+		  name_length_{num_monkeys < 400000 ? 4u : 5u} { }
+
+	std::string add_leaf(long value, std::string name = {}) {
+		if (name.empty())
+			name = next_name();
+		lines_.push_back(name + ": " + std::to_string(value));
+		return name;
+	}
+
+	std::string add_op(const std::string &left, char op, const std::string &right, std::string name = {}) {
+		if (name.empty())
+			name = next_name();
+		lines_.push_back(name + ": " + left + ' ' + op + ' ' + right);
+		return name;
+	}
+
+	/*
+	 * A subtree of the given (odd) number of monkeys that yells the given positive value.
+	 */
+	std::string add_subtree(long value, std::size_t size) {
+		if (size == 1)
+			return add_leaf(value);
+
+		const auto spare_pairs = (size - 3) / 2;
+		const auto left_pairs = random_.uniform(spare_pairs / 4, spare_pairs - spare_pairs / 4);
+		const auto left_size = 2 * left_pairs + 1, right_size = size - 1 - left_size;
+
+		std::vector<char> ops;
+		if (value >= 2)
+			ops.push_back('+');
+		for (long divisor = 2; divisor <= 9; ++divisor) {
+			if (value % divisor == 0) {
+				ops.push_back('*');
+				break;
+			}
+		}
+		if (value < GROWTH_LIMIT)
+			ops.insert(ops.end(), {'-', '/'});
+
+		switch (random_.pick(ops)) {
+		case '+':
+		{
+			const auto left = random_.uniform(1L, value - 1);
+			return add_op(add_subtree(left, left_size), '+', add_subtree(value - left, right_size));
+		}
+		case '*':
+		{
+			long divisor;
+			do {
+				divisor = random_.uniform(2L, 9L);
+			} while (value % divisor != 0);
+			return add_op(add_subtree(divisor, left_size), '*', add_subtree(value / divisor, right_size));
+		}
+		case '-':
+		{
+			const auto right = random_.uniform(1L, 1000L);
+			return add_op(add_subtree(value + right, left_size), '-', add_subtree(right, right_size));
+		}
+		default:
+		{
+			const auto right = random_.uniform(2L, 9L);
+			return add_op(add_subtree(value * right, left_size), '/', add_subtree(right, right_size));
+		}
+		}
+	}
+
+	void write(std::ostream &out) {
+		random_.shuffle(lines_.begin(), lines_.end());
+		for (const auto &line : lines_)
+			out << line << '\n';
+	}
+
+private:
+	Random &random_;
+	std::size_t name_length_;
+	std::size_t next_id_{0};
+	std::vector<std::string> lines_;
+
+	std::string next_name() {
+		for (;;) {
+			std::string name(name_length_, 'a');
+			for (std::size_t i = 0, id = next_id_++; i < name_length_; ++i, id /= 26)
+				name[name_length_ - 1 - i] = static_cast<char>('a' + id % 26);
+			if (name != "root" && name != "humn")
+				return name;
+		}
+	}
+};
+
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const auto num_monkeys = std::max<std::size_t>(scale | 1, 5);
+	const auto path_length = std::clamp<std::size_t>(num_monkeys / 30, 1, 200);
+
+	// Besides root and humn, each operation on the path has a constant subtree and root has the other side. Every
+	// subtree gets one monkey, then the rest are handed out two at a time to keep the sizes odd.
+	std::vector<std::size_t> sizes(path_length + 1, 1);
+	for (auto spare = (num_monkeys - 3 - 2 * path_length) / 2; spare > 0; --spare)
+		sizes[random.uniform<std::size_t>(0, path_length)] += 2;
+
+	Tree_Builder builder{num_monkeys, random};
+	auto value = random.uniform(100L, 5000L);
+	auto path_name = builder.add_leaf(value, "humn");
+	for (std::size_t step = 0; step < path_length; ++step) {
+		const auto size = sizes[step + 1];
+		const auto last = step + 1 == path_length;
+		auto op = last ? '+' : "+-*/"[random.uniform(0, 3)];
+		if (op == '*' && std::abs(value) > GROWTH_LIMIT)
+			op = '+';
+		if (op == '/' && value <= 0 && value % 2 != 0)
+			op = '-';
+
+		switch (op) {
+		case '+':
+		{
+			const auto constant = last ? std::max(1L, 1 - value) + random.uniform(0L, 1000L) : random.uniform(1L, 1000L);
+			path_name = builder.add_op(path_name, '+', builder.add_subtree(constant, size));
+			value += constant;
+			break;
+		}
+		case '-':
+			if (random.chance(0.5) || value > GROWTH_LIMIT) {
+				const auto constant = random.uniform(1L, 1000L);
+				path_name = builder.add_op(path_name, '-', builder.add_subtree(constant, size));
+				value -= constant;
+			} else {
+				const auto constant = std::max(1L, value + random.uniform(1L, 1000L));
+				path_name = builder.add_op(builder.add_subtree(constant, size), '-', path_name);
+				value = constant - value;
+			}
+			break;
+		case '*':
+		{
+			const auto constant = random.uniform(2L, 9L);
+			path_name = builder.add_op(builder.add_subtree(constant, size), '*', path_name);
+			value *= constant;
+			break;
+		}
+		default:
+			if (value > 0 && (value % 2 != 0 || random.chance(0.5))) {
+				const auto multiple = random.uniform(1L, 9L);
+				path_name = builder.add_op(builder.add_subtree(value * multiple, size), '/', path_name);
+				value = multiple;
+			} else {
+				path_name = builder.add_op(path_name, '/', builder.add_subtree(2, size));
+				value /= 2;
+			}
+			break;
+		}
+	}
+	builder.add_op(path_name, '+', builder.add_subtree(value, sizes[0]), "root");
+	builder.write(out);
+}
+
+}
+
+AOC_GENERATOR(21, generate, 2037, "monkeys (odd)")
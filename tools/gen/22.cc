@@ -0,0 +1,32 @@
+#include "gen.h"
+#include <string>
+
+namespace {
+
+static constexpr std::size_t FACE_SIZE{50};
+
+/*
+ * The cube folding is built into the solution (50x50 faces in a fixed net), so the board always has that shape; the
+ * scale sets the number of moves in the path.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	// First and last face column of each band of rows in the net
+	static constexpr std::size_t BANDS[4][2]{{1, 2}, {1, 1}, {0, 1}, {0, 0}};
+	for (const auto &[first_face, last_face] : BANDS) {
+		for (std::size_t r = 0; r < FACE_SIZE; ++r) {
+			std::string row(first_face * FACE_SIZE, ' ');
+			for (auto c = first_face * FACE_SIZE; c < (last_face + 1) * FACE_SIZE; ++c)
+				row.push_back(random.chance(0.1) ? '#' : '.');
+			out << row << '\n';
+		}
+	}
+
+	out << '\n' << random.uniform(1, 50);
+	for (std::size_t move = 1; move < scale; ++move)
+		out << (random.chance(0.5) ? 'R' : 'L') << random.uniform(1, 50);
+	out << '\n';
+}
+
+}
+
+AOC_GENERATOR(22, generate, 2000, "moves")
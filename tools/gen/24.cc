@@ -0,0 +1,121 @@
+#include "gen.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr double BLIZZARD_DENSITY{0.6};
+
+using Bit_Row = std::vector<std::uint64_t>;
+
+/*
+ * The width bits of a row of bits from the given offset on, with a spare word at the end so each word can read the
+ * one after it. Bits past the width are left for the caller to mask.
+ */
+[[nodiscard]] static Bit_Row extract_row(const Bit_Row &bits, std::size_t offset, std::size_t width) {
+	Bit_Row row((width + 63) / 64 + 1, 0);
+	for (std::size_t i = 0; i + 1 < row.size(); ++i) {
+		const auto start = offset + 64 * i, word = start / 64, shift = start % 64;
+		row[i] = bits[word] >> shift | (shift != 0 ? bits[word + 1] << (64 - shift) : 0);
+	}
+	return row;
+}
+
+/*
+ * Whether a walk from the entrance to the exit, back to the entrance and to the exit again gets through, found by
+ * tracking every cell reachable at each minute as rows of bits. A blizzard row moves as a whole: the horizontal ones
+ * are read out of their row laid twice end to end, and the vertical ones are the row they started in that many rows
+ * away. Legs that take more than LEG_LIMIT_FACTOR times the valley's perimeter are counted as blocked, so a jammed
+ * valley is rejected without waiting out the blizzards' whole period.
+ */
+[[nodiscard]] static bool has_round_trip(const std::vector<std::string> &rows) {
+	static constexpr std::size_t LEG_LIMIT_FACTOR{10};
+	const auto height = rows.size() - 2, width = rows.front().size() - 2, words = (width + 63) / 64;
+	std::vector<Bit_Row> east(height, Bit_Row(words * 2 + 2, 0)), west(east), south(height, Bit_Row(words + 1, 0)), north(south);
+	const auto set = [](Bit_Row &row, std::size_t bit) { row[bit / 64] |= std::uint64_t{1} << (bit % 64); };
+	for (std::size_t y = 0; y < height; ++y) {
+		for (std::size_t x = 0; x < width; ++x) {
+			switch (rows[y + 1][x + 1]) {
+			case '>': set(east[y], x); set(east[y], x + width); break;
+			case '<': set(west[y], x); set(west[y], x + width); break;
+			case 'v': set(south[y], x); break;
+			case '^': set(north[y], x); break;
+			}
+		}
+	}
+
+	// Waiting outside at either opening is always safe, so only the valley cells are tracked
+	std::vector<Bit_Row> reached(height, Bit_Row(words + 1, 0)), next(reached);
+	const auto last_bit = std::uint64_t{1} << ((width - 1) % 64);
+	bool at_entrance{true}, at_exit{false}, heading_to_exit{true};
+	std::size_t legs_left{3}, leg_minutes{0};
+	for (std::size_t minute = 1; legs_left > 0; ++minute) {
+		if (++leg_minutes > LEG_LIMIT_FACTOR * (width + height))
+			return false;
+		for (std::size_t y = 0; y < height; ++y) {
+			const auto east_now = extract_row(east[y], width - minute % width, width);
+			const auto west_now = extract_row(west[y], minute % width, width);
+			const auto &south_now = south[(y + height - minute % height) % height];
+			const auto &north_now = north[(y + minute) % height];
+			for (std::size_t i = 0; i < words; ++i) {
+				auto from = reached[y][i] | reached[y][i] << 1 | reached[y][i] >> 1
+						| (i > 0 ? reached[y][i - 1] >> 63 : 0) | reached[y][i + 1] << 63;
+				if (y > 0)
+					from |= reached[y - 1][i];
+				if (y + 1 < height)
+					from |= reached[y + 1][i];
+				if (at_entrance && y == 0 && i == 0)
+					from |= 1;
+				if (at_exit && y == height - 1 && i == words - 1)
+					from |= last_bit;
+				next[y][i] = from & ~(east_now[i] | west_now[i] | south_now[i] | north_now[i]);
+			}
+			if (width % 64 != 0)
+				next[y][words - 1] &= (last_bit << 1) - 1;
+		}
+		std::swap(reached, next);
+		// Reaching the far opening starts the next leg from there alone, a minute later
+		if (heading_to_exit ? (reached[height - 1][words - 1] & last_bit) != 0 : (reached[0][0] & 1) != 0) {
+			for (auto &row : reached)
+				std::fill(row.begin(), row.end(), 0);
+			at_entrance = !heading_to_exit;
+			at_exit = heading_to_exit;
+			heading_to_exit = !heading_to_exit;
+			--legs_left;
+			leg_minutes = 0;
+			++minute;
+		}
+	}
+	return true;
+}
+
+/*
+ * A valley the given number of columns wide and about an eighth as tall (as in the real puzzle, though at least four
+ * rows), with blizzards on BLIZZARD_DENSITY of its cells. As in the real inputs, the entrance and exit columns have
+ * no vertical blizzards. Valleys the expedition cannot cross there, back and there again are drawn again.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	static constexpr char DIRECTIONS[]{'>', '<', 'v', '^'};
+	const auto width = std::max<std::size_t>(scale, 3), height = std::max<std::size_t>(width / 8, 4);
+	std::vector<std::string> rows;
+	do {
+		rows.assign(1, "#." + std::string(width, '#'));
+		for (std::size_t r = 0; r < height; ++r) {
+			std::string row(width + 2, '.');
+			row.front() = row.back() = '#';
+			for (std::size_t c = 0; c < width; ++c) {
+				if (random.chance(BLIZZARD_DENSITY))
+					row[c + 1] = DIRECTIONS[random.uniform(0, c == 0 || c == width - 1 ? 1 : 3)];
+			}
+			rows.push_back(std::move(row));
+		}
+		rows.push_back(std::string(width, '#') + ".#");
+	} while (!has_round_trip(rows));
+	for (const auto &row : rows)
+		out << row << '\n';
+}
+
+}
+
+AOC_GENERATOR(24, generate, 150, "valley width (height is an eighth of it, at least 4)")
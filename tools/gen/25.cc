@@ -0,0 +1,26 @@
+#include "gen.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+static std::string to_snafu(long value) {
+	std::string digits;
+	for (; value > 0; value = (value + 2) / 5)
+		digits.push_back("=-012"[(value + 2) % 5]);
+	std::reverse(digits.begin(), digits.end());
+	return digits;
+}
+
+/*
+ * Values are capped so that the sum of all of them still fits in a long.
+ */
+static void generate(std::ostream &out, std::size_t scale, Random &random) {
+	const auto max_value = std::min<long>(100000000000000L, 4000000000000000000L / std::max<long>(scale, 1));
+	for (std::size_t i = 0; i < scale; ++i)
+		out << to_snafu(random.uniform(1L, max_value)) << '\n';
+}
+
+}
+
+AOC_GENERATOR(25, generate, 126, "numbers")
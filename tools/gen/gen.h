@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*
+ * Deterministic random source for the input generators. Built on mix_hash() rather than <random> so that a given seed
+ * produces the same input with every standard library.
+ */
+struct Random {
+	explicit Random(std::uint64_t seed) noexcept
+		: state_{seed} { }
+
+	[[nodiscard]] std::uint64_t next() noexcept {
+		return mix_hash(state_ += 0x9e3779b97f4a7c15);
+	}
+
+	/*
+	 * Uniform integer in [lo, hi].
+	 */
+	template<typename T>
+	[[nodiscard]] T uniform(T lo, T hi) noexcept {
+		const auto range = static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo) + 1;
+		return static_cast<T>(static_cast<std::uint64_t>(lo) + (range == 0 ? next() : next() % range));
+	}
+
+	[[nodiscard]] bool chance(double probability) noexcept {
+		return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+	}
+
+	template<typename T>
+	[[nodiscard]] const T &pick(const std::vector<T> &values) noexcept {
+		return values[uniform<std::size_t>(0, values.size() - 1)];
+	}
+
+	template<typename Random_AccessT>
+	void shuffle(Random_AccessT first, Random_AccessT last) noexcept {
+		for (auto count = last - first; count > 1; --count)
+			std::swap(first[count - 1], first[uniform<decltype(count)>(0, count - 1)]);
+	}
+
+private:
+	std::uint64_t state_;
+};
+
+/*
+ * Every tools/gen/XX.cc defines a generator that writes a valid input for day XX to the stream, with its size set by
+ * the scale argument, and registers it with AOC_GENERATOR(day, function, default scale, description of the scale).
+ * The default scale roughly matches the size of the bundled input.
+ */
+
+using Generator = void (*)(std::ostream &out, std::size_t scale, Random &random);
+
+struct Registered_Generator {
+	int day;
+	Generator generate;
+	std::size_t default_scale;
+	const char *scale_unit;
+};
+
+[[nodiscard]] inline std::vector<Registered_Generator> &registered_generators() {
+	static std::vector<Registered_Generator> generators;
+	return generators;
+}
+
+struct Generator_Registration {
+	Generator_Registration(int day, Generator generate, std::size_t default_scale, const char *scale_unit) {
+		registered_generators().push_back(Registered_Generator{day, generate, default_scale, scale_unit});
+	}
+};
+
+#define AOC_GENERATOR(DAY, GENERATE, DEFAULT_SCALE, SCALE_UNIT) \
+	static const Generator_Registration generator_registration{DAY, GENERATE, DEFAULT_SCALE, SCALE_UNIT};
@@ -0,0 +1,98 @@
+#include "gen.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*
+ * Synthetic input generator: writes a valid input for one day at the requested scale. The same day, scale and seed
+ * always produce the same bytes.
+ */
+
+struct Options {
+	int day{0};
+	std::size_t scale{0};
+	std::uint64_t seed{2022};
+	std::string output_path;
+};
+
+[[noreturn]] static void usage(const char *prog, int status) {
+	(status == 0 ? std::cout : std::cerr)
+			<< "Usage: " << prog << " -d DAY [options]\n"
+			<< "  -d, --day N           day to generate an input for\n"
+			<< "  -s, --scale N         input size, see --list for what it counts (default: about the bundled size)\n"
+			<< "  -r, --seed N          random seed (default 2022)\n"
+			<< "  -o, --output FILE     write to FILE instead of stdout\n"
+			<< "  -l, --list            list the generators and their scales\n";
+	std::exit(status);
+}
+
+static const Registered_Generator *find_generator(int day) {
+	const auto &generators = registered_generators();
+	const auto it = std::find_if(generators.begin(), generators.end(), [day](const auto &generator) { return generator.day == day; });
+	return it == generators.end() ? nullptr : &*it;
+}
+
+static void list_generators() {
+	auto generators = registered_generators();
+	std::sort(generators.begin(), generators.end(), [](const auto &lhs, const auto &rhs) { return lhs.day < rhs.day; });
+	for (const auto &generator : generators) {
+		std::cout << std::setw(2) << std::setfill('0') << generator.day << std::setfill(' ') << "  "
+				  << std::left << std::setw(40) << generator.scale_unit << std::right
+				  << " (default " << generator.default_scale << ")\n";
+	}
+}
+
+static Options parse_options(int argc, char *argv[]) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg{argv[i]};
+		if (arg == "-h" || arg == "--help")
+			usage(argv[0], 0);
+		if (arg == "-l" || arg == "--list") {
+			list_generators();
+			std::exit(0);
+		}
+		if (i + 1 == argc)
+			usage(argv[0], 1);
+		const std::string value{argv[++i]};
+		if (arg == "-d" || arg == "--day")
+			options.day = parse_number(value);
+		else if (arg == "-s" || arg == "--scale")
+			options.scale = parse_number<std::size_t>(value);
+		else if (arg == "-r" || arg == "--seed")
+			options.seed = parse_number<std::uint64_t>(value);
+		else if (arg == "-o" || arg == "--output")
+			options.output_path = value;
+		else
+			usage(argv[0], 1);
+	}
+	if (options.day == 0)
+		usage(argv[0], 1);
+	return options;
+}
+
+int main(int argc, char *argv[]) {
+	const auto options = parse_options(argc, argv);
+	const auto generator = find_generator(options.day);
+	if (generator == nullptr) {
+		std::cerr << argv[0] << ": no generator for day " << options.day << std::endl;
+		return 1;
+	}
+
+	Random random{mix_hash(options.seed) ^ static_cast<std::uint64_t>(options.day)};
+	const auto scale = options.scale > 0 ? options.scale : generator->default_scale;
+	if (options.output_path.empty()) {
+		generator->generate(std::cout, scale, random);
+		std::cout.flush();
+	} else {
+		std::ofstream out{options.output_path};
+		if (!out) {
+			std::cerr << argv[0] << ": cannot write " << options.output_path << std::endl;
+			return 1;
+		}
+		generator->generate(out, scale, random);
+	}
+	return 0;
+}